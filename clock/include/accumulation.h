@@ -0,0 +1,63 @@
+#ifndef ACCUMULATION_H
+#define ACCUMULATION_H
+
+#include <Arduino.h>
+#include "display_config.h"
+
+// 8-bit per channel accumulation buffers for animations that draw on top of
+// their previous frame and fade it. Repeated fades on RGB565 truncate to 5/6
+// bits every frame, so trails decay in coarse steps and leave colour-shifted
+// residue; doing the decay on 0x00RRGGBB pixels and converting to RGB565 once
+// per frame avoids both.
+//
+// An animation allocates a buffer in init(), makes it current with
+// AnimationUtils::beginAccumulation() at the start of render() and finishes
+// with AnimationUtils::resolveAccumulation(). If the buffer can't be
+// allocated it simply keeps drawing in RGB565.
+namespace Accumulation {
+    const size_t BUFFER_BYTES = DISPLAY_WIDTH * DISPLAY_HEIGHT * sizeof(uint32_t);
+
+    // Zeroed DISPLAY_WIDTH x DISPLAY_HEIGHT buffer from the heap, or nullptr
+    // when accumulation is disabled or there is no room
+    uint32_t* allocate();
+    void release(uint32_t* buffer);
+
+    // Lets the benchmarks compare against plain RGB565 drawing
+    void setEnabled(bool enabled);
+
+    // Heap currently held by accumulation buffers
+    size_t getAllocatedSize();
+
+    // Scale every channel by amount/256
+    void fade(uint32_t* buffer, uint16_t amount);
+
+    // Convert to RGB565 into `frame`
+    void resolve(const uint32_t* buffer, uint16_t* frame);
+
+    inline uint32_t from565(uint16_t color) {
+        return ((uint32_t)(color & 0xF800) << 8) | ((uint32_t)(color & 0x07E0) << 5) | ((color & 0x1F) << 3);
+    }
+
+    inline uint16_t to565(uint32_t pixel) {
+        return ((pixel >> 8) & 0xF800) | ((pixel >> 5) & 0x07E0) | ((pixel >> 3) & 0x1F);
+    }
+
+    // dst + (src - dst) * alpha/256, on red+blue and green in two multiplies
+    inline uint32_t blend(uint32_t dst, uint32_t src, uint16_t alpha) {
+        uint16_t inverse = 256 - alpha;
+        uint32_t rb = ((dst & 0xFF00FF) * inverse + (src & 0xFF00FF) * alpha) >> 8;
+        uint32_t g = ((dst & 0x00FF00) * inverse + (src & 0x00FF00) * alpha) >> 8;
+        return (rb & 0xFF00FF) | (g & 0x00FF00);
+    }
+
+    // Per-channel saturating dst + src
+    inline uint32_t add(uint32_t dst, uint32_t src) {
+        uint32_t rb = (dst & 0xFF00FF) + (src & 0xFF00FF);
+        uint32_t g = (dst & 0x00FF00) + (src & 0x00FF00);
+        // Channel overflows carry into bits 8, 16 and 24; widen each into 0xFF
+        uint32_t carry = (rb & 0x1000100) | (g & 0x10000);
+        return (rb & 0xFF00FF) | (g & 0x00FF00) | (carry - (carry >> 8));
+    }
+}
+
+#endif // ACCUMULATION_H
@@ -0,0 +1,22 @@
+// Generated by scripts/png_sprites.py from the PNGs in assets/sprites; edit those
+// and rebuild rather than changing this file.
+
+#ifndef ALPHA_SPRITES_H
+#define ALPHA_SPRITES_H
+
+#include "animation_utils.h"
+
+// assets/sprites/seabird.png, 7x3
+static const uint16_t seabird_sprite_color[] PROGMEM = {
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+};
+static const uint8_t seabird_sprite_alpha[] PROGMEM = {
+    0, 255, 0, 255, 0, 255, 0,
+    255, 255, 0, 255, 255, 255, 255,
+    0, 0, 0, 0, 255, 255, 0,
+};
+static const AlphaSprite SEABIRD_SPRITE = {7, 3, seabird_sprite_color, seabird_sprite_alpha};
+
+#endif // ALPHA_SPRITES_H
@@ -3,6 +3,68 @@
 
 #include <Arduino.h>
 #include "display.h"
+#include "hot_path.h"
+#include "accumulation.h"
+
+// One colour stop of a gradient. `position` runs from 0 (start) to 255 (end);
+// the channels are RGB, or hue/saturation/lightness (each 0-255) when baked
+// with GRADIENT_HSL.
+struct GradientStop {
+    uint8_t position;
+    uint8_t c1, c2, c3;
+};
+
+enum GradientSpace : uint8_t {
+    GRADIENT_RGB = 0,
+    GRADIENT_HSL
+};
+
+enum GradientEasing : uint8_t {
+    GRADIENT_LINEAR = 0,
+    GRADIENT_EASE_IN_OUT   // Smoothstep within each pair of stops
+};
+
+// A colour for the batch HSL conversion: hue 0-65535 covers one turn,
+// saturation and lightness run 0-255
+struct HSL {
+    uint16_t h;
+    uint8_t s;
+    uint8_t l;
+};
+
+// A run of `length` pixels of one alpha (0-255), starting `x` pixels into
+// its sprite row
+struct SpriteSpan {
+    uint8_t x;
+    uint8_t length;
+    uint8_t alpha;
+};
+
+// A bitmap as run-length spans, generated from it at build time by
+// scripts/sprite_spans.py (see span_sprites.h). Row y's spans are
+// spans[rows[y]] up to spans[rows[y + 1]].
+struct SpanSprite {
+    uint8_t width;
+    uint8_t height;
+    const uint16_t* rows;
+    const SpriteSpan* spans;
+};
+
+// A full colour image with soft edges, converted from a PNG in
+// assets/sprites at build time by scripts/png_sprites.py (see
+// alpha_sprites.h). Row-major pixels; alpha is applied as a 5-bit weight
+// (alpha + 4) >> 3 out of 32 and each colour is stored already multiplied
+// by it, so a blit is one multiply-add per pixel: dst * (1 - a) + src.
+struct AlphaSprite {
+    uint8_t width;
+    uint8_t height;
+    const uint16_t* color;
+    const uint8_t* alpha;
+};
+
+enum SpriteFlags : uint8_t {
+    SPRITE_FLIP_X = 1   // Mirror left to right
+};
 
 class AnimationUtils {
 public:
@@ -10,9 +72,85 @@ public:
     static void drawPixelWithBlend(int x, int y, uint16_t color, uint8_t alpha = 255);
     static uint16_t alphaBlend(int x, int y, uint8_t r, uint8_t g, uint8_t b, uint8_t alpha);
     static void hslToRgb(float h, float s, float l, uint8_t* r, uint8_t* g, uint8_t* b);
+    
+    // Fixed-point HSL, within 1 per 8-bit channel of hslToRgb(). Hue 0-65535
+    // covers one turn, saturation and lightness run 0-255.
+    static void hslToRgbFixed(uint16_t h, uint8_t s, uint8_t l, uint8_t* r, uint8_t* g, uint8_t* b);
+    static uint16_t hslTo565(uint16_t h, uint8_t s, uint8_t l);
+    // Converts `count` colours in one call
+    static void hslTo565Batch(const HSL* colors, uint16_t* out, size_t count);
     static void applyFade(uint8_t fadeAmount);
-    static void drawCircle(float xCenter, float yCenter, float radius, uint16_t color, uint8_t alpha = 255);
-    static void fillCircle(float xCenter, float yCenter, float radius, uint16_t color, uint8_t alpha = 255);
+    
+    // Single pixels and horizontal spans [x0, x1) at alpha/255, clipped to
+    // the display. Like drawPixelWithBlend they draw into the current
+    // accumulation buffer, if any. Unlike it they also draw over white
+    // (0xFFFF) pixels; drawPixelWithBlend leaves those alone.
+    static void blendPixel(int x, int y, uint16_t color, uint8_t alpha);
+    static void blendSpan(int y, int x0, int x1, uint16_t color, uint8_t alpha);
+    
+    // Antialiased circles from integer scanlines: a one pixel wide ring, and
+    // a solid disc with a soft edge
+    static void drawCircle(int xCenter, int yCenter, int radius, uint16_t color, uint8_t alpha = 255);
+    static void fillCircle(int xCenter, int yCenter, int radius, uint16_t color, uint8_t alpha = 255);
+    
+    // Antialiased lines between pixel centres: Wu lines at width 1, filled
+    // quads with soft edges when wider. Polylines take `count` x, y pairs.
+    // Arcs run `sweep` from `startAngle`, both in sin16 units (65536 per
+    // turn, clockwise from +x on screen), as a polyline of short chords.
+    // At width 1 each joint of a polyline or arc is blended once. Wider
+    // ones are drawn as separate quads with no joins, so at alpha < 255
+    // joints show where the quads overlap, and sharp corners have a notch
+    // on the outside.
+    static void drawLine(int x0, int y0, int x1, int y1, uint16_t color, uint8_t alpha = 255, int width = 1);
+    static void drawPolyline(const int16_t* points, int count, uint16_t color, uint8_t alpha = 255,
+                             int width = 1, bool closed = false);
+    static void drawArc(int xCenter, int yCenter, int radius, uint16_t startAngle, uint16_t sweep,
+                        uint16_t color, uint8_t alpha = 255, int width = 1);
+    
+    // Bake a gradient into `size` RGB565 entries; entry i is the colour at
+    // i/size of the way along. Stops must be sorted by position.
+    static void bakeGradient(const GradientStop* stops, uint8_t count, uint16_t* lut, uint16_t size,
+                             GradientSpace space = GRADIENT_RGB, GradientEasing easing = GRADIENT_LINEAR);
+    
+    // Span fills into the render target, clipped to the display
+    static void fillSpan(int y, int x0, int x1, uint16_t color);   // x0 <= x < x1
+    static void fillRows(int y0, int y1, uint16_t color);           // y0 <= y < y1
+    // Row y (or column x) gets lut[y - y0] (lut[x - x0]) across the display
+    static void fillRowsFromLut(int y0, int y1, const uint16_t* lut);
+    static void fillColumnsFromLut(int x0, int x1, int y0, int y1, const uint16_t* lut);
+    // Columns [x0, x1) of the row `dy` half-heights from the centre of an
+    // ellipse, i.e. the x with ((x - centerX) / halfWidth)^2 + dy^2 <= 1,
+    // clipped to the display. Returns false for an empty span.
+    static bool ellipseSpan(float centerX, float halfWidth, float dy, int* x0, int* x1);
+    
+    // Scale a 256-entry RGB565 palette by amount/255 (a whole-screen fade
+    // for indexed animations)
+    static void fadePalette(uint16_t* out, const uint16_t* palette, uint8_t amount);
+    
+    // Per-channel saturating add of two RGB565 colours
+    static uint16_t addSaturate565(uint16_t a, uint16_t b);
+    
+    // Add an 8-bit `mask` (w x h, rows `stride` apart) to the render target
+    // as white light scaled by level/256, saturating each channel. The top
+    // left of the mask goes at (x, y); it is clipped to the display once.
+    static void addSprite(int x, int y, const uint8_t* mask, int w, int h, int stride, uint16_t level);
+    
+    // Draw a span sprite with its top left at (x, y), tinted `color`, each
+    // span at its alpha times alpha/255. Clipped to the display once per
+    // sprite and drawn into the current accumulation buffer, if any.
+    static void drawSprite(int x, int y, const SpanSprite& sprite, uint16_t color, uint8_t alpha = 255);
+    
+    // Draw an alpha sprite in its own colours with its top left at (x, y),
+    // its alpha scaled by alpha/255 and optionally mirrored (SpriteFlags).
+    // Clipped and drawn like the span sprites.
+    static void drawSprite(int x, int y, const AlphaSprite& sprite, uint8_t alpha = 255, uint8_t flags = 0);
+    
+    // While an accumulation buffer is current, drawPixelWithBlend, alphaBlend
+    // and applyFade work on it instead of the display. resolveAccumulation()
+    // converts it into the display's render target and ends it. Passing
+    // nullptr keeps drawing in RGB565.
+    static void beginAccumulation(uint32_t* buffer);
+    static void resolveAccumulation();
     
     // Transparent bitmap drawing - skips empty pixels instead of drawing background
     static void drawBitmapTransparent(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color);
@@ -24,6 +162,10 @@ public:
 
 private:
     static float hueToRgb(float p, float q, float t);
+    static uint16_t hueShape(uint16_t t);
+    static void hslChannels(const uint16_t* shapes, uint8_t s, uint8_t l, uint8_t* r, uint8_t* g, uint8_t* b);
+    
+    static uint32_t* accumulation;
 };
 
 #endif // ANIMATION_UTILS_H
\ No newline at end of file
@@ -2,32 +2,45 @@
 #define ANIMATIONS_COORDINATOR_H
 
 #include <Arduino.h>
+#include "animations_modules.h"
+#include "transitions.h"
 
-// Animation IDs
+// Animation IDs, in registry order
+#define ANIMATION_ID(id, ns, stateBudget) id,
 enum AnimationType {
-    ANIM_PLASMA = 0,
-    ANIM_PARTICLES,
-    ANIM_FIRE,
-    ANIM_GALAXY,
-    ANIM_STARS,
-    ANIM_BEACH,
-    ANIM_DVD_LOGO,
+    ANIMATION_LIST(ANIMATION_ID)
     ANIM_COUNT
 };
+#undef ANIMATION_ID
 
 // Simple global coordination functions
 void initAnimations();
 void renderCurrentAnimation();
+void prepareNextAnimation(); // Call during idle time between frames
 void cycleToNextAnimation();
 void setAnimation(AnimationType type);
 AnimationType getCurrentAnimation();
 const char* getCurrentAnimationName();
 const char* getAnimationName(AnimationType type);
+const AnimationDescriptor& getAnimationDescriptor(AnimationType type);
+unsigned long getFrameInterval(); // Milliseconds between frames of the current animation
 
-// Optional fade states
-void startFadeOut();
-void startFadeIn();
-bool isFading();
+// Shared animation state arena, and what per-animation statics would need
+size_t getAnimationStateSlotSize();  // One slot, all the arena holds between switches
+size_t getAnimationStateArenaSize(); // Heap the arena holds right now
+size_t getAnimationStateTotalSize();
+size_t getTransitionBufferSize(); // Heap held by a running transition
+
+// Transitions between animations
+void setTransitionType(TransitionType type);
+TransitionType getTransitionType();
+uint8_t getTransitionProgress(); // Percent
+bool isFading(); // True while a transition is running
 bool isAnimationFading(); // Alias for isFading()
 
+// Frame timing, used to catch hitches around animation switches
+void recordFrameTime(unsigned long micros);
+unsigned long getWorstFrameTime();
+unsigned long getWorstTransitionFrameTime();
+
 #endif // ANIMATIONS_COORDINATOR_H
\ No newline at end of file
@@ -2,50 +2,117 @@
 #define ANIMATIONS_MODULES_H
 
 #include <Arduino.h>
+#include <new>
+#include "buffer_scan_panel.h"
 
 // Common interface for all animations
-// Each animation namespace implements: init(), render(), getName()
+// Each animation namespace implements init() and a render hook, and
+// describes itself to the coordinator through a constexpr `descriptor`.
+//
+// Most animations implement render(), which draws the next frame. Seekable
+// animations instead implement renderAt(frame), which draws frame `frame`
+// directly as a pure function of the frame index (and of the state set up by
+// init()), so any frame can be produced out of order or skipped when running
+// behind.
+//
+// Animations with expensive set-up (tables, caches, pools) also implement
+// prepare(), which does a bounded slice of that work and returns true once
+// everything is ready. The coordinator calls it during idle time before the
+// animation is switched in; init() finishes whatever is left.
+//
+// Animation state lives in a slot of the coordinator's shared state arena,
+// which only holds the animations on screen (plus the one being prepared).
+// Each animation declares its State privately; its size is budgeted in
+// ANIMATION_LIST below, which the arena slots are sized from at compile
+// time, and checked against that budget next to the State. prepare() and
+// init() receive the slot and construct the State there; teardown()
+// destroys it when the animation is switched out.
+struct AnimationDescriptor {
+    const char* name;
+    bool (*prepare)(void* memory);  // nullptr when there is nothing to warm up
+    void (*init)(void* memory);
+    void (*render)(uint32_t frame); // renderAt() or renderNext<render>
+    void (*teardown)();
+    bool seekable;                  // render honours the frame index
+    bool indexed;                   // draws through resolveIndexed(), so fades by palette
+    AntialiasMode antialias;        // Post-process preferred by this animation
+    uint8_t targetFps;
+    size_t stateSize;               // sizeof(State)
+};
 
-namespace PlasmaAnimation {
-    void init();
-    void render();
-    const char* getName();
-}
+// Handle to an animation's State while it is constructed in the arena
+template <typename T>
+class ArenaState {
+public:
+    T& construct(void* memory) {
+        destroy();
+        ptr = new (memory) T();
+        return *ptr;
+    }
 
-namespace ParticlesAnimation {
-    void init();
-    void render();
-    const char* getName();
-}
+    void destroy() {
+        if (ptr) {
+            ptr->~T();
+            ptr = nullptr;
+        }
+    }
 
-namespace FireAnimation {
-    void init();
-    void render();
-    const char* getName();
+    bool constructed() const { return ptr != nullptr; }
+    T* operator->() const { return ptr; }
+    T& operator*() const { return *ptr; }
+
+private:
+    T* ptr = nullptr;
+};
+
+// Render hook for animations that can only draw their next frame
+template <void (*Render)()>
+void renderNext(uint32_t) {
+    Render();
 }
 
-namespace GalaxyAnimation {
-    void init();
-    void render();
-    const char* getName();
+// Settings some animations expose to the web API and benchmarks. Their state
+// is private to their source file.
+namespace FireAnimation {
+    // Tunables, kept across switches. Changes apply from the next frame.
+    struct Settings {
+        uint8_t flameHeight = 60;   // How far up the panel a spark carries, 10-100%
+        uint8_t cooling = 96;       // Random cooling on top of that; higher is more ragged
+        uint8_t sparkRate = 140;    // Chance of a spark per bottom pixel per frame, /256
+    };
+    
+    void setSettings(const Settings& settings);
+    const Settings& getSettings();
 }
 
 namespace StarAnimation {
-    void init();
-    void render();
-    const char* getName();
+    const uint16_t MAX_STARS = 400;
+    
+    // Stars drawn each frame, 1 to MAX_STARS; kept across switches
+    void setStarCount(uint16_t count);
+    uint16_t getStarCount();
 }
 
-namespace BeachAnimation {
-    void init();
-    void render();
-    const char* getName();
-}
+// The animation registry. Adding an animation means writing its source file
+// (with its State and descriptor) and adding one line here; the order sets
+// AnimationType. The last column is the most the animation's State may
+// take in bytes, a multiple of 16 that fits it on the board and on a 64-bit
+// host; each source file static_asserts its State against it.
+#define ANIMATION_LIST(X) \
+    X(ANIM_PLASMA, PlasmaAnimation, 1280) \
+    X(ANIM_PARTICLES, ParticlesAnimation, 176) \
+    X(ANIM_FIRE, FireAnimation, 528) \
+    X(ANIM_GALAXY, GalaxyAnimation, 1728) \
+    X(ANIM_STARS, StarAnimation, 4064) \
+    X(ANIM_BEACH, BeachAnimation, 256) \
+    X(ANIM_DVD_LOGO, DVDLogoAnimation, 16)
 
-namespace DVDLogoAnimation {
-    void init();
-    void render();
-    const char* getName();
-}
+#define DECLARE_ANIMATION(id, ns, stateBudget) \
+    namespace ns { \
+        extern const AnimationDescriptor descriptor; \
+        constexpr size_t STATE_BUDGET = stateBudget; \
+    }
+ANIMATION_LIST(DECLARE_ANIMATION)
+#undef DECLARE_ANIMATION
 
-#endif // ANIMATIONS_MODULES_H
\ No newline at end of file
+#endif // ANIMATIONS_MODULES_H
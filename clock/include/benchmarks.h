@@ -0,0 +1,19 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+// On-device benchmarks, built only with -DCLOCK_BENCHMARKS (see env:bench).
+// Results go to Serial as one line per case:
+//
+//   BENCH <group> <case> frames=<n> avg_us=<average> worst_us=<worst>
+//
+// scripts/compare_benchmarks.py diffs two such logs, e.g. env:bench against
+// env:bench-iram.
+#ifdef CLOCK_BENCHMARKS
+
+// Runs every benchmark. Call after displayInit() and before initAnimations(),
+// as the animation cases init and tear down each animation in turn.
+void runBenchmarks();
+
+#endif
+
+#endif // BENCHMARKS_H
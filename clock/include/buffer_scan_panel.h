@@ -10,43 +10,149 @@
 #define ESP_HUB75_32x16MatrixPanel
 
 #include "display_config.h"
+#include "hot_path.h"
+#include "dither.h"
 #include <ESP32-HUB75-VirtualMatrixPanel_T.hpp>
 
-class BufferMatrixPanel : public VirtualMatrixPanel_T<CHAIN_NONE> {
-  using VirtualMatrixPanel_T<CHAIN_NONE>::VirtualMatrixPanel_T;
+// Post-process applied to the composed frame before it is pushed out
+enum AntialiasMode : uint8_t {
+  AA_NONE = 0,
+  AA_BOX_3X3  // 50% blend with a 3x3 box filter
+};
+
+// Frame buffer of W x H pixels in front of the DMA output, which is a grid of
+// TILE_W x TILE_H panels chained in the given layout. The dimensions are
+// template parameters so every per-pixel loop has constant bounds; the
+// members are defined in buffer_scan_panel.cpp and instantiated there for the
+// configured display.
+//
+// The buffer stays row-major across the whole display. Each panel is a tile
+// of it with its own dirty state, so flip() only post-processes and pushes
+// the panels that changed.
+template <int W, int H, int TILE_W = W, int TILE_H = H, PANEL_CHAIN_TYPE CHAIN = CHAIN_NONE>
+class BufferMatrixPanelT : public VirtualMatrixPanel_T<CHAIN> {
+  using Output = VirtualMatrixPanel_T<CHAIN>;
+  using Output::Output;
+
+  static_assert(W % TILE_W == 0 && H % TILE_H == 0, "Display must be a whole number of panels");
+  static_assert(TILE_W % 2 == 0, "Tile signatures hash pixel pairs");
 
  public:
+  static constexpr int WIDTH = W;
+  static constexpr int HEIGHT = H;
+  static constexpr int TILE_COLS = W / TILE_W;
+  static constexpr int TILE_ROWS = H / TILE_H;
+  static constexpr int TILES = TILE_COLS * TILE_ROWS;
+
+  // Size of one full RGB565 frame
+  static constexpr size_t FRAME_BYTES = W * H * sizeof(uint16_t);
+  // The antialiasing pass only keeps the two rows above the one it is on
+  static constexpr size_t ANTIALIAS_BUFFER_BYTES = 2 * W * sizeof(uint16_t);
+
   void drawPixel(int16_t x, int16_t y, uint16_t color) override;
   void drawPixelRGB888(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b);
 
   inline void clearData() {
-    for (int x = 0; x < DISPLAY_WIDTH; x++) {
-      for (int y = 0; y < DISPLAY_HEIGHT; y++) {
-        pixelData[x][y] = 0;
-      }
-    }
+    memset(target, 0, FRAME_BYTES);
   }
 
-  inline void flip() {
-    applyAntialiasing();
-    for (int x = 0; x < DISPLAY_WIDTH; x++) {
-      for (int y = 0; y < DISPLAY_HEIGHT; y++) {
-        VirtualMatrixPanel_T<CHAIN_NONE>::drawPixel(x, y, pixelData[x][y]);
-      }
+  // Redirect drawing into another W x H row-major buffer, e.g. to render a
+  // second animation off screen. Passing nullptr restores the frame buffer.
+  // flip() always reads the frame buffer.
+  inline void setRenderTarget(uint16_t* buffer) {
+    target = buffer ? buffer : pixelData;
+  }
+
+  inline uint16_t* getFrameBuffer() { return pixelData; }
+  inline uint16_t* getRenderTarget() { return target; }
+
+  // Indexed colour. Animations whose colour is a function of one value
+  // (plasma level, flame heat) write 8-bit palette indices, W x H row-major,
+  // into the first half of the render target and then expand them through a
+  // 256-entry RGB565 palette in place. Writing a frame touches half the
+  // bytes, and fading or cycling the whole screen is a palette operation.
+  inline uint8_t* getIndexedTarget() { return (uint8_t*)target; }
+  void resolveIndexed(const uint16_t* palette, uint8_t rotate = 0);
+
+  // Brightness (0-255) resolveIndexed() applies to the palette, so indexed
+  // animations can be faded without an extra frame buffer
+  inline void setPaletteLevel(uint8_t level) { paletteLevel = level; }
+  inline uint8_t getPaletteLevel() const { return paletteLevel; }
+
+  // Post-processes the composed frame and pushes it to the DMA output, one
+  // panel at a time. Panels identical to the last ones pushed are skipped.
+  void flip();
+
+  // Filters the whole frame, or only the tiles flagged in `tiles`
+  void applyAntialiasing(const bool* tiles = nullptr);
+
+  inline void setAntialiasMode(AntialiasMode mode) {
+    if (mode != antialiasMode) {
+      antialiasMode = mode;
+      invalidateFrame();
     }
   }
 
-  void applyAntialiasing();
+  // Dithering applied while pushing, down to `bits` bits per channel (1-8).
+  // Temporal dithering changes the output every frame, so while it is on
+  // flip() pushes every tile of every frame: no unchanged tiles or frames
+  // are skipped.
+  inline void setDither(DitherMode mode, uint8_t bits) {
+    if (mode >= DITHER_COUNT || bits < 1 || bits > 8) return;
+    ditherMode = mode;
+    ditherBits = bits;
+    invalidateFrame();
+  }
+
+  inline DitherMode getDitherMode() const { return ditherMode; }
+  inline uint8_t getDitherBits() const { return ditherBits; }
+
+  // Cheap signature of one tile of the composed (pre-antialiasing) frame
+  uint32_t tileSignature(int tile) const;
+
+  // Make the next flip() push every tile, e.g. after the output was cleared
+  inline void invalidateFrame() {
+    memset(tileValid, 0, sizeof(tileValid));
+  }
+
+  inline uint32_t getFlippedFrames() const { return flippedFrames; }
+  inline uint32_t getSkippedFrames() const { return skippedFrames; }
+  inline uint32_t getPushedTiles() const { return pushedTiles; }
+  inline uint32_t getSkippedTiles() const { return skippedTiles; }
 
   uint16_t getPixel(int16_t x, int16_t y) { 
-    if (x < 0 || x >= DISPLAY_WIDTH || y < 0 || y >= DISPLAY_HEIGHT) {
+    if (x < 0 || x >= W || y < 0 || y >= H) {
       return 0;
     }
-    return pixelData[x][y]; 
+    return target[y * W + x]; 
   }
 
  private:
-  uint16_t pixelData[DISPLAY_WIDTH][DISPLAY_HEIGHT] = {};
+  void pushTile(int tile);
+
+  // Row-major frame buffer
+  uint16_t pixelData[W * H] = {};
+  uint16_t* target = pixelData;
+
+  AntialiasMode antialiasMode = AA_BOX_3X3;
+  uint8_t paletteLevel = 255;
+
+  // Gamma correction spreads the 565 levels between output levels at any
+  // depth (the darkest greens are below one 8-bit step), so dither by default
+  DitherMode ditherMode = DITHER_ORDERED;
+  uint8_t ditherBits = DISPLAY_DITHER_BITS;
+  uint32_t ditherFrame = 0;
+
+  uint32_t tileSignatures[TILES] = {};
+  bool tileValid[TILES] = {};
+  uint32_t flippedFrames = 0;
+  uint32_t skippedFrames = 0;
+  uint32_t pushedTiles = 0;
+  uint32_t skippedTiles = 0;
 };
 
+// The panel everything draws to
+using BufferMatrixPanel = BufferMatrixPanelT<DISPLAY_WIDTH, DISPLAY_HEIGHT,
+                                             PANEL_RES_X, PANEL_RES_Y, DISPLAY_CHAIN_LAYOUT>;
+
 #endif
@@ -1,7 +1,46 @@
 #ifndef DISPLAY_CONFIG_H
 #define DISPLAY_CONFIG_H
 
+// Panel resolution, overridable from the build flags. Layouts derive from
+// these, and 64x32, 128x64 and 256x64 are all supported.
+#ifndef DISPLAY_WIDTH
 #define DISPLAY_WIDTH 128
+#endif
+
+#ifndef DISPLAY_HEIGHT
 #define DISPLAY_HEIGHT 64
+#endif
+
+// Physical panel size. Larger displays are driven as a grid of panels
+// chained together, e.g. 2x1 or 2x2 panels of 128x64.
+#ifndef PANEL_RES_X
+#define PANEL_RES_X (DISPLAY_WIDTH < 128 ? DISPLAY_WIDTH : 128)
+#endif
+
+#ifndef PANEL_RES_Y
+#define PANEL_RES_Y (DISPLAY_HEIGHT < 64 ? DISPLAY_HEIGHT : 64)
+#endif
+
+#define PANEL_COLS (DISPLAY_WIDTH / PANEL_RES_X)
+#define PANEL_ROWS (DISPLAY_HEIGHT / PANEL_RES_Y)
+#define PANEL_CHAIN (PANEL_COLS * PANEL_ROWS)
+
+// How the chain runs through a grid of panels (a PANEL_CHAIN_TYPE of the
+// HUB75 library). A single row of panels needs no remapping.
+#ifndef DISPLAY_CHAIN_LAYOUT
+#define DISPLAY_CHAIN_LAYOUT (PANEL_ROWS > 1 ? CHAIN_TOP_RIGHT_DOWN : CHAIN_NONE)
+#endif
+
+// Colour depth the frame is dithered down to on its way to the DMA output.
+// Lowering the library's PIXEL_COLOR_DEPTH_BITS (e.g. -DPIXEL_COLOR_DEPTH_BITS=4)
+// raises the refresh rate and saves DMA memory; dithering keeps the
+// perceived depth close.
+#ifndef DISPLAY_DITHER_BITS
+#ifdef PIXEL_COLOR_DEPTH_BITS
+#define DISPLAY_DITHER_BITS PIXEL_COLOR_DEPTH_BITS
+#else
+#define DISPLAY_DITHER_BITS 8
+#endif
+#endif
 
-#endif // DISPLAY_CONFIG_H
\ No newline at end of file
+#endif // DISPLAY_CONFIG_H
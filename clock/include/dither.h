@@ -0,0 +1,42 @@
+#ifndef DITHER_H
+#define DITHER_H
+
+#include <Arduino.h>
+
+// How the frame is reduced to the colour depth the DMA output runs at. The
+// HUB75 library's own CIE1931 correction is turned off (NO_CIE1931 in
+// platformio.ini) because it would run after the dither and undo it; the
+// same curve is applied here first, at 16 bits, and the dither works on
+// the corrected values.
+enum DitherMode : uint8_t {
+    DITHER_NONE = 0,   // Truncate
+    DITHER_ORDERED,    // 8x8 Bayer pattern
+    DITHER_TEMPORAL,   // Bayer pattern cycling over 4 frames, for 2 more bits of perceived depth.
+                       // The output changes every frame, so every tile is pushed every frame.
+    DITHER_COUNT
+};
+
+namespace Dither {
+    // 8x8 Bayer matrix, thresholds 0-63
+    extern const uint8_t BAYER_8X8[8][8];
+
+    // CIE1931 lightness to 16-bit PWM duty, for 5-bit (red, blue) and 6-bit
+    // (green) RGB565 channels; the curve the library applies with lumConvTab
+    extern const uint16_t GAMMA_5[32];
+    extern const uint16_t GAMMA_6[64];
+
+    // Per-column offsets (x & 7) to add to 16-bit corrected channel values
+    // of row `y` before truncating them to `bits` bits
+    void rowOffsets(DitherMode mode, uint8_t bits, int y, uint32_t frame, uint16_t offsets[8]);
+
+    // One channel: add the offset and keep the top bits selected by `mask`,
+    // as the 8-bit value the library takes
+    inline uint8_t apply(uint16_t value, uint16_t offset, uint8_t mask) {
+        uint32_t dithered = (uint32_t)value + offset;
+        return (dithered > 0xFFFF ? 0xFF : dithered >> 8) & mask;
+    }
+
+    const char* getName(DitherMode mode);
+}
+
+#endif // DITHER_H
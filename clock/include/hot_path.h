@@ -0,0 +1,16 @@
+#ifndef HOT_PATH_H
+#define HOT_PATH_H
+
+#include <Arduino.h>
+
+// Marks a function that runs over the whole frame every frame. Built with
+// -DCLOCK_HOT_IRAM=1 these are placed in IRAM, where they no longer compete
+// with the DMA and WiFi for the flash cache. IRAM is scarce, so only mark
+// kernels the benchmarks (env:bench vs env:bench-iram) show to be worth it.
+#if defined(CLOCK_HOT_IRAM) && CLOCK_HOT_IRAM
+#define CLOCK_HOT_PATH IRAM_ATTR
+#else
+#define CLOCK_HOT_PATH
+#endif
+
+#endif // HOT_PATH_H
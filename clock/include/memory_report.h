@@ -0,0 +1,19 @@
+#ifndef MEMORY_REPORT_H
+#define MEMORY_REPORT_H
+
+#include <Arduino.h>
+
+// Memory accounting: static buffers per module, heap by capability and
+// stack high-water marks of the tasks we care about.
+
+// Must be called from the loop task (i.e. from setup()) so that task's
+// stack can be tracked
+void memoryReportInit();
+
+// Current figures as JSON, served at /api/memory
+String memoryReportJson();
+
+// Same figures in a readable form on Serial
+void memoryReportPrint();
+
+#endif // MEMORY_REPORT_H
@@ -0,0 +1,55 @@
+#ifndef PACKED565_H
+#define PACKED565_H
+
+#include <Arduino.h>
+
+// RGB565 spread to 0000 0GGG GGG0 0000 RRRR R000 000B BBBB. Every channel has
+// spare bits above it, so all three can be scaled by a 5-bit weight (out of
+// 32) with one multiply, or added with their carries caught. The one copy of
+// these kernels, for the transitions, the AnimationUtils blends and sprites.
+namespace Packed565 {
+    const uint32_t MASK = 0x07E0F81F;
+
+    // Half of 32 in each channel, to round a scaled colour to nearest
+    const uint32_t ROUND = (16 << 21) | (16 << 11) | 16;
+
+    inline uint32_t spread(uint16_t color) {
+        return (color | ((uint32_t)color << 16)) & MASK;
+    }
+
+    inline uint16_t pack(uint32_t color) {
+        return (uint16_t)(color | (color >> 16));
+    }
+
+    // Alpha 0-255 as a weight out of 32
+    inline uint32_t weight(uint8_t alpha) {
+        return (alpha + 4) >> 3;
+    }
+
+    // color * weight/32 per channel, rounded down or (with ROUND) to nearest
+    inline uint32_t scale(uint32_t color, uint32_t weight, uint32_t round = 0) {
+        return ((color * weight + round) >> 5) & MASK;
+    }
+
+    // dst + (src - dst) * weight/32 per channel, rounded down. The borrows of
+    // negative differences stay in the spare bits and are masked off.
+    inline uint32_t mix(uint32_t dst, uint32_t src, uint32_t weight) {
+        return ((((src - dst) * weight) >> 5) + dst) & MASK;
+    }
+
+    inline uint16_t blend(uint16_t dst, uint16_t src, uint32_t weight) {
+        return pack(mix(spread(dst), spread(src), weight));
+    }
+
+    // Per-channel saturating a + b
+    inline uint16_t addSaturate(uint16_t a, uint16_t b) {
+        uint32_t sum = spread(a) + spread(b);
+        uint32_t carries = sum & 0x08010020;
+
+        // Turn each carry into a full channel mask (green is 6 bits wide)
+        sum |= carries - (((carries & 0x08000000) >> 6) | ((carries & 0x00010020) >> 5));
+        return pack(sum & MASK);
+    }
+}
+
+#endif // PACKED565_H
@@ -0,0 +1,95 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <Arduino.h>
+#include "display_config.h"
+
+// A particle engine for animations with many small moving dots. Particles
+// live in a fixed-capacity pool stored as one array per field, so the
+// update and draw passes each stream through the fields they need. Live
+// particles are always [0, count): spawning appends and killing moves the
+// last particle into the hole, both O(1).
+//
+// Positions and velocities are 10.6 fixed point (1/64 pixel), which covers
+// +-512 pixels. Pool storage comes from the heap, like the accumulation
+// buffers.
+namespace Particles {
+    const int POSITION_SHIFT = 6;
+    
+    // Pixels to 10.6
+    inline int16_t toFixed(float pixels) {
+        return (int16_t)lroundf(pixels * (1 << POSITION_SHIFT));
+    }
+    
+    struct Pool {
+        int16_t* x = nullptr;
+        int16_t* y = nullptr;
+        int16_t* vx = nullptr;      // Per frame
+        int16_t* vy = nullptr;
+        uint16_t* color = nullptr;  // RGB565
+        uint8_t* life = nullptr;    // Frames left
+        uint16_t capacity = 0;
+        uint16_t count = 0;
+    };
+    
+    // Sets up `pool` for `capacity` particles; false (and an empty pool)
+    // when there is no room
+    bool allocate(Pool& pool, uint16_t capacity);
+    void release(Pool& pool);
+    
+    // Heap currently held by particle pools
+    size_t getAllocatedSize();
+    
+    // False when the pool is full, or for a particle with no life to live
+    inline bool spawn(Pool& pool, int16_t x, int16_t y, int16_t vx, int16_t vy, uint8_t life, uint16_t color) {
+        if (pool.count >= pool.capacity || life == 0) return false;
+        
+        uint16_t i = pool.count++;
+        pool.x[i] = x;
+        pool.y[i] = y;
+        pool.vx[i] = vx;
+        pool.vy[i] = vy;
+        pool.life[i] = life;
+        pool.color[i] = color;
+        return true;
+    }
+    
+    // The last particle takes the place of particle i
+    inline void kill(Pool& pool, uint16_t i) {
+        uint16_t last = --pool.count;
+        pool.x[i] = pool.x[last];
+        pool.y[i] = pool.y[last];
+        pool.vx[i] = pool.vx[last];
+        pool.vy[i] = pool.vy[last];
+        pool.life[i] = pool.life[last];
+        pool.color[i] = pool.color[last];
+    }
+    
+    // Spawns particles at a steady rate from a point. Callers move it and
+    // change its colour between frames as they like.
+    struct Emitter {
+        int16_t x = 0, y = 0;       // 10.6
+        int16_t vx = 0, vy = 0;     // Velocity of new particles, 10.6 per frame
+        int16_t spread = 0;         // Random +-spread added to each velocity component
+        uint16_t rate = 256;        // Particles per frame, 8.8
+        uint8_t life = 255;         // Frames each particle lives
+        uint16_t color = 0xFFFF;
+        uint16_t owed = 0;          // Fraction of a particle carried to the next frame
+    };
+    
+    // This frame's particles from `emitter`
+    void emit(Pool& pool, Emitter& emitter);
+    
+    // Moves every particle by its velocity, adds `gravity` (10.6 per frame)
+    // to its vertical velocity and ages it. Particles that expire or move
+    // more than a dot's width off the display are killed.
+    void update(Pool& pool, int16_t gravity = 0);
+    
+    // Draws every particle as a soft dot DOT_SIZE pixels across, fading out
+    // over its last frames. Blends into `accumulation` when there is one,
+    // else into the render target.
+    const int DOT_SIZE = 5;
+    void draw(const Pool& pool, uint32_t* accumulation);
+}
+
+#endif // PARTICLES_H
@@ -0,0 +1,42 @@
+// Generated by scripts/sprite_spans.py from the bitmaps it lists; edit
+// those and rebuild rather than changing this file.
+
+#ifndef SPAN_SPRITES_H
+#define SPAN_SPRITES_H
+
+#include "animation_utils.h"
+
+// include/dvd_logo.h, 37x31, 93 spans
+static const SpriteSpan dvd_logo_sprite_spans[] PROGMEM = {
+    {4, 12, 255}, {21, 9, 255},  // 2
+    {4, 12, 255}, {21, 10, 255},  // 3
+    {9, 4, 255}, {14, 2, 255}, {21, 2, 255}, {28, 4, 255},  // 4
+    {4, 3, 255}, {10, 7, 255}, {20, 6, 255}, {29, 4, 255},  // 5
+    {4, 3, 255}, {11, 3, 255}, {15, 2, 255}, {20, 2, 255}, {23, 3, 255}, {30, 3, 255},  // 6
+    {4, 3, 255}, {11, 3, 255}, {15, 3, 255}, {19, 3, 255}, {23, 3, 255}, {30, 3, 255},  // 7
+    {4, 3, 255}, {10, 4, 255}, {16, 2, 255}, {19, 2, 255}, {23, 3, 255}, {29, 4, 255},  // 8
+    {4, 9, 255}, {16, 5, 255}, {23, 9, 255},  // 9
+    {4, 8, 255}, {16, 5, 255}, {23, 8, 255},  // 10
+    {4, 6, 255}, {17, 3, 255}, {23, 6, 255},  // 11
+    {17, 3, 255},  // 12
+    {18, 1, 255},  // 13
+    {11, 15, 255},  // 14
+    {6, 25, 255},  // 15
+    {3, 13, 255}, {21, 13, 255},  // 16
+    {2, 12, 255}, {23, 12, 255},  // 17
+    {3, 13, 255}, {22, 12, 255},  // 18
+    {4, 29, 255},  // 19
+    {7, 23, 255},  // 20
+    {7, 1, 255}, {12, 1, 255}, {16, 3, 255}, {22, 4, 255}, {31, 2, 255},  // 23
+    {3, 1, 255}, {7, 1, 255}, {12, 1, 255}, {16, 1, 255}, {19, 1, 255}, {22, 1, 255}, {30, 1, 255}, {33, 1, 255},  // 24
+    {4, 1, 255}, {6, 1, 255}, {12, 1, 255}, {16, 1, 255}, {19, 1, 255}, {22, 1, 255}, {30, 1, 255}, {33, 1, 255},  // 25
+    {4, 1, 255}, {6, 1, 255}, {12, 1, 255}, {16, 1, 255}, {19, 1, 255}, {22, 3, 255}, {30, 1, 255}, {33, 1, 255},  // 26
+    {4, 1, 255}, {6, 1, 255}, {12, 1, 255}, {16, 1, 255}, {19, 1, 255}, {22, 1, 255}, {30, 1, 255}, {33, 1, 255},  // 27
+    {5, 1, 255}, {12, 1, 255}, {16, 3, 255}, {22, 4, 255}, {31, 2, 255},  // 28
+};
+static const uint16_t dvd_logo_sprite_rows[] PROGMEM = {
+    0, 0, 0, 2, 4, 8, 12, 18, 24, 30, 33, 36, 39, 40, 41, 42, 43, 45, 47, 49, 50, 51, 51, 51, 56, 64, 72, 80, 88, 93, 93, 93
+};
+static const SpanSprite DVD_LOGO_SPRITE = {37, 31, dvd_logo_sprite_rows, dvd_logo_sprite_spans};
+
+#endif // SPAN_SPRITES_H
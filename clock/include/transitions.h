@@ -0,0 +1,28 @@
+#ifndef TRANSITIONS_H
+#define TRANSITIONS_H
+
+#include <Arduino.h>
+
+// How the outgoing animation is replaced by the incoming one
+enum TransitionType {
+    TRANSITION_CROSSFADE = 0,
+    TRANSITION_WIPE,
+    TRANSITION_DISSOLVE,
+    TRANSITION_SLIDE,
+    TRANSITION_COUNT
+};
+
+namespace Transitions {
+    // Full scale for transition progress (8.8 fixed point)
+    const uint16_t PROGRESS_MAX = 256;
+
+    // Write the mix of `outgoing` and `incoming` to every pixel of `out`, all
+    // DISPLAY_WIDTH x DISPLAY_HEIGHT row-major RGB565 buffers. The sources are
+    // left alone, so each animation keeps drawing on its own previous frame.
+    // progress runs from 0 (all outgoing) to PROGRESS_MAX (all incoming).
+    void blend(TransitionType type, uint16_t* out, const uint16_t* outgoing, const uint16_t* incoming, uint16_t progress);
+
+    const char* getName(TransitionType type);
+}
+
+#endif // TRANSITIONS_H
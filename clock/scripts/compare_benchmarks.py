@@ -0,0 +1,56 @@
+# Compare two on-device benchmark logs (serial output of env:bench builds),
+# e.g. flash-resident against IRAM hot paths:
+#
+#   python scripts/compare_benchmarks.py bench.log bench-iram.log
+#
+# or builds at different resolutions (env:bench-64x32, env:bench-256x64), in
+# which case the pixel ratio is printed for reference.
+
+import re
+import sys
+
+BENCH_LINE = re.compile(r"BENCH (\S+) (.+?) frames=\d+ avg_us=(\d+) worst_us=(\d+)")
+START_LINE = re.compile(r"BENCH start (\d+)x(\d+)")
+
+
+def load(path):
+    results = {}
+    pixels = 0
+    with open(path, errors="replace") as f:
+        for line in f:
+            start = START_LINE.search(line)
+            if start:
+                pixels = int(start.group(1)) * int(start.group(2))
+            match = BENCH_LINE.search(line)
+            if match:
+                results[(match.group(1), match.group(2))] = (int(match.group(3)), int(match.group(4)))
+    return results, pixels
+
+
+def change(before, after):
+    if before == 0:
+        return "      -"
+    return "%+6.1f%%" % (100.0 * (after - before) / before)
+
+
+def main(base_path, other_path):
+    base, base_pixels = load(base_path)
+    other, other_pixels = load(other_path)
+
+    if base_pixels and other_pixels and base_pixels != other_pixels:
+        print("pixels: %d -> %d (x%.2f)" % (base_pixels, other_pixels, float(other_pixels) / base_pixels))
+
+    print("%-32s %9s %9s %8s %10s %10s %8s" %
+          ("case", "avg", "avg'", "", "worst", "worst'", ""))
+    for key in sorted(base):
+        if key not in other:
+            continue
+        (avg, worst), (avg2, worst2) = base[key], other[key]
+        print("%-32s %9d %9d %8s %10d %10d %8s" %
+              (" ".join(key), avg, avg2, change(avg, avg2), worst, worst2, change(worst, worst2)))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        sys.exit("usage: compare_benchmarks.py <base.log> <other.log>")
+    main(sys.argv[1], sys.argv[2])
@@ -0,0 +1,144 @@
+# PlatformIO post script: link with a map file and summarise where the
+# firmware's DRAM, IRAM and flash go, per project source file and per library,
+# and which project functions ended up in IRAM (see CLOCK_HOT_PATH).
+#
+#   extra_scripts = post:scripts/memory_map_report.py
+#
+# Can also be run by hand on an existing map: python memory_map_report.py firmware.map
+
+import os
+import re
+import sys
+from collections import defaultdict
+
+# Output sections we care about, grouped by the memory they end up in
+REGIONS = {
+    ".dram0.data": "dram",
+    ".dram0.bss": "dram",
+    ".iram0.text": "iram",
+    ".iram0.vectors": "iram",
+    ".flash.text": "flash",
+    ".flash.rodata": "flash",
+    ".flash.appdesc": "flash",
+}
+
+OUTPUT_SECTION = re.compile(r"^(\.\S+)")
+INPUT_SECTION = re.compile(r"^ (\.\S+)?\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S+)")
+INPUT_NAME_ONLY = re.compile(r"^ (\.\S+)\s*$")
+SYMBOL_LINE = re.compile(r"^\s+0x[0-9a-f]+\s+([A-Za-z_].*?)\s*$")
+MEMORY_SEGMENT = re.compile(r"^(\w+)\s+0x[0-9a-f]+\s+0x([0-9a-f]+)")
+
+
+def owner_of(path):
+    """Map an object file path to 'src/<file>', a library name or 'other'."""
+    path = path.replace("\\", "/")
+    match = re.search(r"/build/[^/]+/src/(.+?)\.(?:cpp|c)\.o$", path)
+    if match:
+        return "src/" + match.group(1)
+    match = re.search(r"/lib([^/]+)\.a\(", path) or re.search(r"/lib[^/]*/([^/]+)/", path)
+    if match:
+        return match.group(1)
+    return "other"
+
+
+def parse_map(map_path):
+    totals = defaultdict(lambda: defaultdict(int))
+    # Project code placed in IRAM (CLOCK_HOT_PATH), as [owner, symbol, size]
+    iram_functions = []
+    iram_capacity = 0
+    region = None
+    pending_name = False
+    pending_symbol = None
+
+    with open(map_path, errors="replace") as f:
+        in_memory_map = False
+        for line in f:
+            if not in_memory_map:
+                segment = MEMORY_SEGMENT.match(line)
+                if segment and segment.group(1).startswith("iram0_0_seg"):
+                    iram_capacity = int(segment.group(2), 16)
+                if line.startswith("Linker script and memory map"):
+                    in_memory_map = True
+                continue
+
+            section = OUTPUT_SECTION.match(line)
+            if section:
+                region = REGIONS.get(section.group(1))
+                pending_symbol = None
+                continue
+            if region is None:
+                continue
+
+            # The symbol defined by an input section is listed on the line after it
+            symbol = SYMBOL_LINE.match(line)
+            if symbol and pending_symbol is not None:
+                pending_symbol[1] = symbol.group(1)
+                pending_symbol = None
+                continue
+
+            # Long input section names put address, size and object on the next line
+            if INPUT_NAME_ONLY.match(line):
+                pending_name = True
+                continue
+
+            entry = INPUT_SECTION.match(line)
+            if entry and (entry.group(1) or pending_name):
+                size = int(entry.group(3), 16)
+                if size:
+                    owner = owner_of(entry.group(4))
+                    totals[owner][region] += size
+                    if region == "iram" and owner.startswith("src/"):
+                        pending_symbol = [owner, "?", size]
+                        iram_functions.append(pending_symbol)
+            pending_name = False
+
+    return totals, iram_functions, iram_capacity
+
+
+def print_report(totals, iram_functions, iram_capacity):
+    print("")
+    print("Memory by module (bytes)")
+    print("%-40s %8s %8s %8s" % ("module", "dram", "iram", "flash"))
+
+    def row(name, sizes):
+        print("%-40s %8d %8d %8d" % (name, sizes["dram"], sizes["iram"], sizes["flash"]))
+
+    project = sorted(k for k in totals if k.startswith("src/"))
+    libraries = sorted((k for k in totals if not k.startswith("src/")),
+                       key=lambda k: -sum(totals[k].values()))
+
+    for name in project:
+        row(name, totals[name])
+    print("-" * 67)
+    for name in libraries:
+        row(name, totals[name])
+
+    overall = defaultdict(int)
+    for sizes in totals.values():
+        for region, size in sizes.items():
+            overall[region] += size
+    print("-" * 67)
+    row("total", overall)
+
+    print("")
+    if iram_capacity:
+        print("IRAM: %d of %d bytes used, %d free" %
+              (overall["iram"], iram_capacity, iram_capacity - overall["iram"]))
+    print("Project functions in IRAM: %d bytes" % sum(f[2] for f in iram_functions))
+    for owner, symbol, size in sorted(iram_functions, key=lambda f: -f[2]):
+        print("  %6d  %s  (%s)" % (size, symbol, owner))
+    print("")
+
+
+def report_after_link(source, target, env):
+    map_path = os.path.join(env.subst("$BUILD_DIR"), "firmware.map")
+    if os.path.exists(map_path):
+        print_report(*parse_map(map_path))
+
+
+if __name__ == "__main__":
+    print_report(*parse_map(sys.argv[1]))
+else:
+    Import("env")  # noqa: F821 (provided by PlatformIO/SCons)
+    env.Append(LINKFLAGS=["-Wl,-Map,${BUILD_DIR}/firmware.map"])  # noqa: F821
+    env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", report_after_link)  # noqa: F821
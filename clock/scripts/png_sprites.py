@@ -0,0 +1,160 @@
+# PlatformIO pre script: convert every PNG in assets/sprites into an
+# AlphaSprite (include/animation_utils.h) in include/alpha_sprites.h. Pixels are
+# stored as RGB565 premultiplied by their alpha, plus the alpha itself, so the
+# blitter only has to do dst * (1 - a) + src. The header is only rewritten
+# when a PNG is newer than it.
+#
+#   extra_scripts = pre:scripts/png_sprites.py
+#
+# Can also be run by hand from the project directory: python scripts/png_sprites.py
+#
+# Only the PNG features image editors write for small sprites are read:
+# 8 bits per channel, greyscale or RGB with or without alpha, or 8-bit
+# palettes (with tRNS transparency), not interlaced. No dependencies beyond
+# the standard library.
+
+import os
+import re
+import struct
+import sys
+import zlib
+
+SOURCE_DIR = "assets/sprites"
+OUTPUT = "include/alpha_sprites.h"
+
+# Channels per pixel by PNG colour type
+CHANNELS = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}
+
+
+def paeth(a, b, c):
+    p = a + b - c
+    pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+    if pa <= pb and pa <= pc:
+        return a
+    return b if pb <= pc else c
+
+
+def read_png(path):
+    """(width, height, rows of (r, g, b, a) pixels)"""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:8] != b"\x89PNG\r\n\x1a\n":
+        raise ValueError("%s is not a PNG" % path)
+
+    chunks = {}
+    idat = b""
+    offset = 8
+    while offset < len(data):
+        length, kind = struct.unpack(">I4s", data[offset:offset + 8])
+        body = data[offset + 8:offset + 8 + length]
+        offset += 12 + length
+        if kind == b"IDAT":
+            idat += body
+        else:
+            chunks[kind] = body
+
+    width, height, depth, color_type, _, _, interlace = struct.unpack(">IIBBBBB", chunks[b"IHDR"])
+    if depth != 8 or interlace or color_type not in CHANNELS:
+        raise ValueError("%s: only 8-bit, non-interlaced PNGs are supported" % path)
+
+    channels = CHANNELS[color_type]
+    stride = width * channels
+    raw = zlib.decompress(idat)
+    rows = []
+    previous = bytearray(stride)
+    for y in range(height):
+        start = y * (stride + 1)
+        kind = raw[start]
+        line = bytearray(raw[start + 1:start + 1 + stride])
+        for i in range(stride):
+            left = line[i - channels] if i >= channels else 0
+            up = previous[i]
+            upper_left = previous[i - channels] if i >= channels else 0
+            if kind == 1:
+                line[i] = (line[i] + left) & 0xFF
+            elif kind == 2:
+                line[i] = (line[i] + up) & 0xFF
+            elif kind == 3:
+                line[i] = (line[i] + ((left + up) >> 1)) & 0xFF
+            elif kind == 4:
+                line[i] = (line[i] + paeth(left, up, upper_left)) & 0xFF
+        previous = line
+        rows.append(line)
+
+    palette = chunks.get(b"PLTE", b"")
+    transparency = chunks.get(b"tRNS", b"")
+    pixels = []
+    for line in rows:
+        row = []
+        for x in range(width):
+            p = line[x * channels:(x + 1) * channels]
+            if color_type == 0:
+                row.append((p[0], p[0], p[0], 255))
+            elif color_type == 2:
+                row.append((p[0], p[1], p[2], 255))
+            elif color_type == 3:
+                alpha = transparency[p[0]] if p[0] < len(transparency) else 255
+                row.append(tuple(palette[p[0] * 3:p[0] * 3 + 3]) + (alpha,))
+            elif color_type == 4:
+                row.append((p[0], p[0], p[0], p[1]))
+            else:
+                row.append(tuple(p))
+        pixels.append(row)
+    return width, height, pixels
+
+
+def premultiplied565(r, g, b, a):
+    """RGB565 with each channel scaled by the blitter's 5-bit alpha weight"""
+    weight = (a + 4) >> 3
+    return ((((r >> 3) * weight) >> 5) << 11) | ((((g >> 2) * weight) >> 5) << 5) | (((b >> 3) * weight) >> 5)
+
+
+def generate(project_dir):
+    source_dir = os.path.join(project_dir, SOURCE_DIR)
+    sources = sorted(os.path.join(source_dir, name) for name in os.listdir(source_dir) if name.lower().endswith(".png"))
+
+    output = os.path.join(project_dir, OUTPUT)
+    if os.path.exists(output) and all(os.path.getmtime(s) <= os.path.getmtime(output) for s in sources):
+        return
+
+    lines = [
+        "// Generated by scripts/png_sprites.py from the PNGs in %s; edit those" % SOURCE_DIR,
+        "// and rebuild rather than changing this file.",
+        "",
+        "#ifndef ALPHA_SPRITES_H",
+        "#define ALPHA_SPRITES_H",
+        "",
+        '#include "animation_utils.h"',
+    ]
+    for path in sources:
+        width, height, pixels = read_png(path)
+        if width > 255 or height > 255:
+            raise ValueError("%s is larger than 255x255" % path)
+
+        # seabird.png -> SEABIRD_SPRITE
+        name = re.sub(r"\W", "_", os.path.splitext(os.path.basename(path))[0]).upper() + "_SPRITE"
+        prefix = name.lower()
+        lines += [
+            "",
+            "// %s/%s, %dx%d" % (SOURCE_DIR, os.path.basename(path), width, height),
+            "static const uint16_t %s_color[] PROGMEM = {" % prefix,
+        ]
+        lines += ["    " + " ".join("0x%04X," % premultiplied565(*p) for p in row) for row in pixels]
+        lines += ["};", "static const uint8_t %s_alpha[] PROGMEM = {" % prefix]
+        lines += ["    " + " ".join("%d," % p[3] for p in row) for row in pixels]
+        lines += [
+            "};",
+            "static const AlphaSprite %s = {%d, %d, %s_color, %s_alpha};" % (name, width, height, prefix, prefix),
+        ]
+    lines += ["", "#endif // ALPHA_SPRITES_H", ""]
+
+    with open(output, "w") as f:
+        f.write("\n".join(lines))
+    print("png_sprites: wrote %s" % OUTPUT)
+
+
+if __name__ == "__main__":
+    generate(os.getcwd() if len(sys.argv) < 2 else sys.argv[1])
+else:
+    Import("env")  # noqa: F821 (provided by PlatformIO/SCons)
+    generate(env.subst("$PROJECT_DIR"))  # noqa: F821
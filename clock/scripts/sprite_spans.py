@@ -0,0 +1,126 @@
+# PlatformIO pre script: convert the bitmaps listed in SPRITES into run-length
+# span lists (include/span_sprites.h) for AnimationUtils::drawSprite, so the
+# firmware never walks a bitmap bit by bit. The header is only rewritten when
+# a source is newer than it.
+#
+#   extra_scripts = pre:scripts/sprite_spans.py
+#
+# Can also be run by hand from the project directory: python scripts/sprite_spans.py
+
+import os
+import re
+import sys
+
+# (sprite name, source header, array, width, height, bits per pixel). Width
+# and height may be numbers or #defines from the source header; 1 bit pixels
+# are rows padded to whole bytes, MSB first, 8 bit pixels are alpha values.
+SPRITES = [
+    ("DVD_LOGO_SPRITE", "include/dvd_logo.h", "dvd_logo_bitmap", "dvdLogoImageWidth", "dvdLogoImageHeight", 1),
+]
+
+OUTPUT = "include/span_sprites.h"
+
+DEFINE = re.compile(r"^\s*#define\s+(\w+)\s+(\d+)", re.MULTILINE)
+NUMBER = re.compile(r"0x[0-9a-fA-F]+|\d+")
+
+
+def load_array(text, name):
+    match = re.search(r"\b" + re.escape(name) + r"\s*\[\s*\]\s*[^=]*=\s*\{(.*?)\}", text, re.DOTALL)
+    if not match:
+        raise ValueError("array %s not found" % name)
+    body = re.sub(r"//.*|/\*.*?\*/", "", match.group(1), flags=re.DOTALL)
+    return [int(value, 0) for value in NUMBER.findall(body)]
+
+
+def resolve(value, defines):
+    return value if isinstance(value, int) else int(defines[value])
+
+
+def alpha_rows(data, width, height, bits):
+    """The bitmap as rows of 0-255 alpha values."""
+    rows = []
+    if bits == 1:
+        stride = (width + 7) // 8
+        for y in range(height):
+            rows.append([255 if data[y * stride + x // 8] & (0x80 >> (x & 7)) else 0 for x in range(width)])
+    else:
+        for y in range(height):
+            rows.append(data[y * width:(y + 1) * width])
+    return rows
+
+
+def spans(row):
+    """Runs of one non-zero alpha as (x, length, alpha)."""
+    runs = []
+    x = 0
+    while x < len(row):
+        alpha = row[x]
+        start = x
+        while x < len(row) and row[x] == alpha and x - start < 255:
+            x += 1
+        if alpha:
+            runs.append((start, x - start, alpha))
+    return runs
+
+
+def generate(project_dir):
+    sources = []
+    sprites = []
+    for name, header, array, width, height, bits in SPRITES:
+        path = os.path.join(project_dir, header)
+        sources.append(path)
+        with open(path) as f:
+            text = f.read()
+        defines = dict(DEFINE.findall(text))
+        width = resolve(width, defines)
+        height = resolve(height, defines)
+        if width > 255 or height > 255:
+            raise ValueError("%s is larger than 255x255" % name)
+        rows = [spans(row) for row in alpha_rows(load_array(text, array), width, height, bits)]
+        sprites.append((name, header, width, height, rows))
+
+    output = os.path.join(project_dir, OUTPUT)
+    if os.path.exists(output) and all(os.path.getmtime(s) <= os.path.getmtime(output) for s in sources):
+        return
+
+    lines = [
+        "// Generated by scripts/sprite_spans.py from the bitmaps it lists; edit",
+        "// those and rebuild rather than changing this file.",
+        "",
+        "#ifndef SPAN_SPRITES_H",
+        "#define SPAN_SPRITES_H",
+        "",
+        '#include "animation_utils.h"',
+    ]
+    for name, header, width, height, rows in sprites:
+        prefix = name.lower()
+        offsets = [0]
+        for row in rows:
+            offsets.append(offsets[-1] + len(row))
+        lines += [
+            "",
+            "// %s, %dx%d, %d spans" % (header, width, height, offsets[-1]),
+            "static const SpriteSpan %s_spans[] PROGMEM = {" % prefix,
+        ]
+        for y, row in enumerate(rows):
+            if row:
+                lines.append("    " + " ".join("{%d, %d, %d}," % span for span in row) + "  // %d" % y)
+        lines += [
+            "};",
+            "static const uint16_t %s_rows[] PROGMEM = {" % prefix,
+            "    " + ", ".join(str(offset) for offset in offsets),
+            "};",
+            "static const SpanSprite %s = {%d, %d, %s_rows, %s_spans};" % (name, width, height, prefix, prefix),
+        ]
+    lines += ["", "#endif // SPAN_SPRITES_H", ""]
+
+    with open(output, "w") as f:
+        f.write("\n".join(lines))
+    print("sprite_spans: wrote %s" % OUTPUT)
+
+
+if __name__ == "__main__":
+    generate(os.getcwd() if len(sys.argv) < 2 else sys.argv[1])
+else:
+    Import("env")  # noqa: F821 (provided by PlatformIO/SCons)
+    generate(env.subst("$PROJECT_DIR"))  # noqa: F821
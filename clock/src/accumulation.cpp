@@ -0,0 +1,46 @@
+#include "accumulation.h"
+#include "hot_path.h"
+
+namespace Accumulation {
+    static bool enabled = true;
+    static size_t allocatedSize = 0;
+
+    uint32_t* allocate() {
+        if (!enabled) return nullptr;
+        
+        uint32_t* buffer = (uint32_t*)calloc(1, BUFFER_BYTES);
+        if (buffer) {
+            allocatedSize += BUFFER_BYTES;
+        }
+        return buffer;
+    }
+
+    void release(uint32_t* buffer) {
+        if (buffer) {
+            free(buffer);
+            allocatedSize -= BUFFER_BYTES;
+        }
+    }
+
+    void setEnabled(bool enable) {
+        enabled = enable;
+    }
+
+    size_t getAllocatedSize() {
+        return allocatedSize;
+    }
+
+    void CLOCK_HOT_PATH fade(uint32_t* buffer, uint16_t amount) {
+        for (int i = 0; i < DISPLAY_WIDTH * DISPLAY_HEIGHT; i++) {
+            uint32_t pixel = buffer[i];
+            buffer[i] = (((pixel & 0xFF00FF) * amount >> 8) & 0xFF00FF) |
+                        (((pixel & 0x00FF00) * amount >> 8) & 0x00FF00);
+        }
+    }
+
+    void CLOCK_HOT_PATH resolve(const uint32_t* buffer, uint16_t* frame) {
+        for (int i = 0; i < DISPLAY_WIDTH * DISPLAY_HEIGHT; i++) {
+            frame[i] = to565(buffer[i]);
+        }
+    }
+}
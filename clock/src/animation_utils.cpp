@@ -1,4 +1,8 @@
 #include "animation_utils.h"
+#include "packed565.h"
+#include <FastLED.h>
+
+uint32_t* AnimationUtils::accumulation = nullptr;
 
 uint16_t AnimationUtils::rgb888To565(uint8_t r, uint8_t g, uint8_t b) {
     return ((r & 0b11111000) << 8) | ((g & 0b11111100) << 3) | (b >> 3);
@@ -12,6 +16,13 @@ void AnimationUtils::rgb565To888(uint16_t color, uint8_t* r, uint8_t* g, uint8_t
 
 void AnimationUtils::drawPixelWithBlend(int x, int y, uint16_t color, uint8_t alpha) {
     if (x < 0 || x >= DISPLAY_WIDTH || y < 0 || y >= DISPLAY_HEIGHT) return;
+    
+    if (accumulation) {
+        uint32_t& pixel = accumulation[y * DISPLAY_WIDTH + x];
+        pixel = Accumulation::blend(pixel, Accumulation::from565(color), alpha + (alpha >> 7));
+        return;
+    }
+    
     if (display.getPixel(x,y) == 0xFFFF) return;
     
     if (alpha == 255) {
@@ -25,6 +36,12 @@ void AnimationUtils::drawPixelWithBlend(int x, int y, uint16_t color, uint8_t al
 }
 
 uint16_t AnimationUtils::alphaBlend(int x, int y, uint8_t r, uint8_t g, uint8_t b, uint8_t alpha) {
+        if (accumulation && x >= 0 && x < DISPLAY_WIDTH && y >= 0 && y < DISPLAY_HEIGHT) {
+            uint32_t existing = accumulation[y * DISPLAY_WIDTH + x];
+            uint32_t color = ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+            return Accumulation::to565(Accumulation::blend(existing, color, alpha + (alpha >> 7)));
+        }
+        
         uint16_t existing = display.getPixel(x, y);
         uint8_t er, eg, eb;
         rgb565To888(existing, &er, &eg, &eb);
@@ -59,7 +76,57 @@ float AnimationUtils::hueToRgb(float p, float q, float t) {
     return p;
 }
 
-void AnimationUtils::applyFade(uint8_t fadeAmount) {
+// hueToRgb()'s piecewise ramp as a 0-65535 weight of q over p, for t in 0-65535
+uint16_t AnimationUtils::hueShape(uint16_t t) {
+    if (t < 10923) return t * 6;                // Rising, up to 1/6
+    if (t < 32768) return 65535;                // Flat, up to 1/2
+    if (t < 43691) return (43690 - t) * 6;      // Falling, up to 2/3
+    return 0;
+}
+
+void AnimationUtils::hslChannels(const uint16_t* shapes, uint8_t s, uint8_t l, uint8_t* r, uint8_t* g, uint8_t* b) {
+    // Same maths as hslToRgb() with lightness and saturation as 0-65535
+    uint32_t L = l * 257;
+    uint32_t S = s * 257;
+    uint32_t LS = (L * S) >> 16;
+    uint32_t q = L < 32768 ? L + LS : L + S - LS;
+    uint32_t p = 2 * L > q ? 2 * L - q : 0;
+    
+    uint8_t* channels[3] = {r, g, b};
+    for (int i = 0; i < 3; i++) {
+        uint32_t value = p + (((q - p) * shapes[i]) >> 16);
+        *channels[i] = (value * 255) >> 16;
+    }
+}
+
+void AnimationUtils::hslToRgbFixed(uint16_t h, uint8_t s, uint8_t l, uint8_t* r, uint8_t* g, uint8_t* b) {
+    // Red, green and blue sample the ramp a third of a turn apart
+    uint16_t shapes[3] = {
+        hueShape(h + 21845),
+        hueShape(h),
+        hueShape(h - 21845)
+    };
+    hslChannels(shapes, s, l, r, g, b);
+}
+
+uint16_t AnimationUtils::hslTo565(uint16_t h, uint8_t s, uint8_t l) {
+    uint8_t r, g, b;
+    hslToRgbFixed(h, s, l, &r, &g, &b);
+    return rgb888To565(r, g, b);
+}
+
+void AnimationUtils::hslTo565Batch(const HSL* colors, uint16_t* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = hslTo565(colors[i].h, colors[i].s, colors[i].l);
+    }
+}
+
+void CLOCK_HOT_PATH AnimationUtils::applyFade(uint8_t fadeAmount) {
+    if (accumulation) {
+        Accumulation::fade(accumulation, fadeAmount + (fadeAmount >> 7));
+        return;
+    }
+    
     // Apply fade by reducing brightness of all pixels
     for (int y = 0; y < DISPLAY_HEIGHT; y++) {
         for (int x = 0; x < DISPLAY_WIDTH; x++) {
@@ -79,6 +146,140 @@ void AnimationUtils::applyFade(uint8_t fadeAmount) {
     }
 }
 
+void AnimationUtils::bakeGradient(const GradientStop* stops, uint8_t count, uint16_t* lut, uint16_t size,
+                                  GradientSpace space, GradientEasing easing) {
+    uint8_t segment = 0;
+    for (uint16_t i = 0; i < size; i++) {
+        // Position along the gradient in 8.8 fixed point
+        uint32_t position = ((uint32_t)i * 255 << 8) / size;
+        while (segment + 2 < count && position >= ((uint32_t)stops[segment + 1].position << 8)) {
+            segment++;
+        }
+        
+        const GradientStop& from = stops[segment];
+        const GradientStop& to = stops[count > 1 ? segment + 1 : 0];
+        
+        // Fraction through this pair of stops, 0-256
+        uint32_t start = (uint32_t)from.position << 8;
+        uint32_t span = ((uint32_t)to.position << 8) - start;
+        uint32_t t = span == 0 || position <= start ? 0 : ((position - start) << 8) / span;
+        if (t > 256) {
+            t = 256;
+        }
+        if (easing == GRADIENT_EASE_IN_OUT) {
+            t = (t * t * (768 - 2 * t)) >> 16;
+        }
+        
+        uint8_t c1 = from.c1 + (((int)to.c1 - from.c1) * (int)t >> 8);
+        uint8_t c2 = from.c2 + (((int)to.c2 - from.c2) * (int)t >> 8);
+        uint8_t c3 = from.c3 + (((int)to.c3 - from.c3) * (int)t >> 8);
+        
+        if (space == GRADIENT_HSL) {
+            uint8_t r, g, b;
+            hslToRgb(c1 / 255.0f, c2 / 255.0f, c3 / 255.0f, &r, &g, &b);
+            lut[i] = rgb888To565(r, g, b);
+        } else {
+            lut[i] = rgb888To565(c1, c2, c3);
+        }
+    }
+}
+
+void AnimationUtils::fillSpan(int y, int x0, int x1, uint16_t color) {
+    if (y < 0 || y >= DISPLAY_HEIGHT) return;
+    x0 = max(0, x0);
+    x1 = min(DISPLAY_WIDTH, x1);
+    
+    uint16_t* row = display.getRenderTarget() + y * DISPLAY_WIDTH;
+    for (int x = x0; x < x1; x++) {
+        row[x] = color;
+    }
+}
+
+void AnimationUtils::fillRows(int y0, int y1, uint16_t color) {
+    for (int y = max(0, y0); y < min(DISPLAY_HEIGHT, y1); y++) {
+        fillSpan(y, 0, DISPLAY_WIDTH, color);
+    }
+}
+
+void AnimationUtils::fillRowsFromLut(int y0, int y1, const uint16_t* lut) {
+    for (int y = max(0, y0); y < min(DISPLAY_HEIGHT, y1); y++) {
+        fillSpan(y, 0, DISPLAY_WIDTH, lut[y - y0]);
+    }
+}
+
+void AnimationUtils::fillColumnsFromLut(int x0, int x1, int y0, int y1, const uint16_t* lut) {
+    int start = max(0, x0);
+    int end = min(DISPLAY_WIDTH, x1);
+    if (start >= end) return;
+    
+    // Fill the first row, then copy it down
+    uint16_t* target = display.getRenderTarget();
+    y0 = max(0, y0);
+    y1 = min(DISPLAY_HEIGHT, y1);
+    if (y0 >= y1) return;
+    
+    uint16_t* first = target + y0 * DISPLAY_WIDTH;
+    for (int x = start; x < end; x++) {
+        first[x] = lut[x - x0];
+    }
+    for (int y = y0 + 1; y < y1; y++) {
+        memcpy(target + y * DISPLAY_WIDTH + start, first + start, (end - start) * sizeof(uint16_t));
+    }
+}
+
+bool AnimationUtils::ellipseSpan(float centerX, float halfWidth, float dy, int* x0, int* x1) {
+    float remaining = 1.0f - dy * dy;
+    if (remaining < 0) return false;
+    
+    float reach = halfWidth * sqrtf(remaining);
+    *x0 = max(0, (int)ceilf(centerX - reach));
+    *x1 = min(DISPLAY_WIDTH, (int)floorf(centerX + reach) + 1);
+    return *x0 < *x1;
+}
+
+void AnimationUtils::fadePalette(uint16_t* out, const uint16_t* palette, uint8_t amount) {
+    for (int i = 0; i < 256; i++) {
+        uint8_t r, g, b;
+        rgb565To888(palette[i], &r, &g, &b);
+        out[i] = rgb888To565((r * amount) / 255, (g * amount) / 255, (b * amount) / 255);
+    }
+}
+
+uint16_t AnimationUtils::addSaturate565(uint16_t a, uint16_t b) {
+    return Packed565::addSaturate(a, b);
+}
+
+void CLOCK_HOT_PATH AnimationUtils::addSprite(int x, int y, const uint8_t* mask, int w, int h, int stride, uint16_t level) {
+    int x0 = x < 0 ? -x : 0;
+    int y0 = y < 0 ? -y : 0;
+    int x1 = x + w > DISPLAY_WIDTH ? DISPLAY_WIDTH - x : w;
+    int y1 = y + h > DISPLAY_HEIGHT ? DISPLAY_HEIGHT - y : h;
+    if (x0 >= x1 || y0 >= y1) return;
+    
+    uint16_t* target = display.getRenderTarget();
+    for (int j = y0; j < y1; j++) {
+        const uint8_t* maskRow = mask + j * stride;
+        uint16_t* row = target + (y + j) * DISPLAY_WIDTH + x;
+        for (int i = x0; i < x1; i++) {
+            uint8_t v = (maskRow[i] * level) >> 8;
+            if (!v) continue;
+            uint16_t grey = ((v >> 3) << 11) | ((v >> 2) << 5) | (v >> 3);
+            row[i] = Packed565::addSaturate(row[i], grey);
+        }
+    }
+}
+
+void AnimationUtils::beginAccumulation(uint32_t* buffer) {
+    accumulation = buffer;
+}
+
+void AnimationUtils::resolveAccumulation() {
+    if (accumulation) {
+        Accumulation::resolve(accumulation, display.getRenderTarget());
+        accumulation = nullptr;
+    }
+}
+
 void AnimationUtils::drawBitmapTransparent(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color) {
     int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
     uint8_t b = 0;
@@ -98,56 +299,435 @@ void AnimationUtils::drawBitmapTransparent(int16_t x, int16_t y, const uint8_t b
     }
 }
 
-void AnimationUtils::drawCircle(float xCenter, float yCenter, float radius, uint16_t color, uint8_t alpha) {
-    int x0 = round(xCenter);
-    int y0 = round(yCenter);
-    int r0 = round(radius);
+// Edge coverage against the signed distance of a pixel centre from the
+// circle's edge, in 1/16 pixel. A fill edge covers -8..8 (half a pixel
+// either side), an outline -16..16 (one pixel either side of the ring).
+static const uint8_t FILL_EDGE[17] = {
+    255, 240, 224, 208, 192, 176, 160, 144, 128, 112, 96, 80, 64, 48, 32, 16, 0
+};
+static const uint8_t RING_EDGE[33] = {
+    0, 16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240, 255,
+    240, 224, 208, 192, 176, 160, 144, 128, 112, 96, 80, 64, 48, 32, 16, 0
+};
+
+// dst + (src - dst) * alpha/256 on RGB565, with 5-bit weights on the spread
+// channels
+static inline uint16_t blend565(uint16_t dst, uint16_t src, uint8_t alpha) {
+    return Packed565::blend(dst, src, Packed565::weight(alpha));
+}
+
+void AnimationUtils::blendPixel(int x, int y, uint16_t color, uint8_t alpha) {
+    if ((unsigned)x >= DISPLAY_WIDTH || (unsigned)y >= DISPLAY_HEIGHT || !alpha) return;
+    
+    if (accumulation) {
+        uint32_t& pixel = accumulation[y * DISPLAY_WIDTH + x];
+        pixel = Accumulation::blend(pixel, Accumulation::from565(color), alpha + (alpha >> 7));
+        return;
+    }
+    uint16_t& pixel = display.getRenderTarget()[y * DISPLAY_WIDTH + x];
+    pixel = alpha == 255 ? color : blend565(pixel, color, alpha);
+}
+
+// [x0, x1) of row y at alpha/255, already clipped to the display
+static inline void blendRun(uint32_t* accumulation, int y, int x0, int x1, uint16_t color, uint8_t alpha) {
+    if (accumulation) {
+        uint32_t* row = accumulation + y * DISPLAY_WIDTH;
+        uint32_t packed = Accumulation::from565(color);
+        if (alpha == 255) {
+            for (int x = x0; x < x1; x++) row[x] = packed;
+        } else {
+            uint16_t weight = alpha + (alpha >> 7);
+            for (int x = x0; x < x1; x++) row[x] = Accumulation::blend(row[x], packed, weight);
+        }
+        return;
+    }
+    
+    uint16_t* row = display.getRenderTarget() + y * DISPLAY_WIDTH;
+    if (alpha == 255) {
+        for (int x = x0; x < x1; x++) row[x] = color;
+    } else {
+        for (int x = x0; x < x1; x++) row[x] = blend565(row[x], color, alpha);
+    }
+}
+
+void AnimationUtils::blendSpan(int y, int x0, int x1, uint16_t color, uint8_t alpha) {
+    if (y < 0 || y >= DISPLAY_HEIGHT || !alpha) return;
+    x0 = max(0, x0);
+    x1 = min(DISPLAY_WIDTH, x1);
+    if (x0 >= x1) return;
+    
+    blendRun(accumulation, y, x0, x1, color, alpha);
+}
+
+void CLOCK_HOT_PATH AnimationUtils::drawSprite(int x, int y, const SpanSprite& sprite, uint16_t color, uint8_t alpha) {
+    int j0 = y < 0 ? -y : 0;
+    int j1 = y + sprite.height > DISPLAY_HEIGHT ? DISPLAY_HEIGHT - y : sprite.height;
+    if (j0 >= j1 || !alpha || x >= DISPLAY_WIDTH || x + sprite.width <= 0) return;
+    
+    // Spans only need clipping when the sprite hangs off the side
+    bool clipped = x < 0 || x + sprite.width > DISPLAY_WIDTH;
+    uint16_t scale = alpha + 1;
+    
+    for (int j = j0; j < j1; j++) {
+        const SpriteSpan* span = sprite.spans + sprite.rows[j];
+        const SpriteSpan* end = sprite.spans + sprite.rows[j + 1];
+        for (; span < end; span++) {
+            int x0 = x + span->x;
+            int x1 = x0 + span->length;
+            if (clipped) {
+                x0 = max(0, x0);
+                x1 = min(DISPLAY_WIDTH, x1);
+                if (x0 >= x1) continue;
+            }
+            blendRun(accumulation, y + j, x0, x1, color, (span->alpha * scale) >> 8);
+        }
+    }
+}
+
+// Premultiplied `src` over an accumulation pixel that keeps `keep`/32 of
+// itself, at 8 bits per channel
+static inline uint32_t overAccumulated(uint32_t pixel, uint16_t src, uint32_t keep) {
+    uint32_t rb = (((pixel & 0xFF00FF) * keep) >> 5) & 0xFF00FF;
+    uint32_t g = (((pixel & 0x00FF00) * keep) >> 5) & 0x00FF00;
+    return (rb | g) + Accumulation::from565(src);
+}
+
+void CLOCK_HOT_PATH AnimationUtils::drawSprite(int x, int y, const AlphaSprite& sprite, uint8_t alpha, uint8_t flags) {
+    int i0 = x < 0 ? -x : 0;
+    int j0 = y < 0 ? -y : 0;
+    int i1 = x + sprite.width > DISPLAY_WIDTH ? DISPLAY_WIDTH - x : sprite.width;
+    int j1 = y + sprite.height > DISPLAY_HEIGHT ? DISPLAY_HEIGHT - y : sprite.height;
+    if (i0 >= i1 || j0 >= j1 || !alpha) return;
     
-    int x = r0;
-    int y = 0;
-    int err = 0;
+    // Screen column i shows sprite column i, or width - 1 - i flipped
+    int step = flags & SPRITE_FLIP_X ? -1 : 1;
+    int first = step < 0 ? sprite.width - 1 - i0 : i0;
+    uint32_t scale = Packed565::weight(alpha);
+    uint16_t* target = display.getRenderTarget();
+    
+    for (int j = j0; j < j1; j++) {
+        const uint16_t* color = sprite.color + j * sprite.width + first;
+        const uint8_t* coverage = sprite.alpha + j * sprite.width + first;
+        int index = (y + j) * DISPLAY_WIDTH + x;
+        
+        for (int i = i0; i < i1; i++, color += step, coverage += step) {
+            if (!*coverage) continue;
+            
+            uint32_t weight = Packed565::weight(*coverage);
+            uint32_t src = Packed565::spread(*color);
+            if (scale < 32) {
+                // Rounding the weight up keeps the sum within each channel
+                weight = (weight * scale + 31) >> 5;
+                src = Packed565::scale(src, scale);
+            }
+            
+            if (accumulation) {
+                uint32_t& pixel = accumulation[index + i];
+                pixel = weight == 32 ? Accumulation::from565(*color) : overAccumulated(pixel, Packed565::pack(src), 32 - weight);
+            } else {
+                // The premultiplied source is rounded down, so rounding the
+                // destination's share to nearest never carries
+                uint16_t& pixel = target[index + i];
+                pixel = weight == 32 ? *color : Packed565::pack(Packed565::scale(Packed565::spread(pixel), 32 - weight, Packed565::ROUND) + src);
+            }
+        }
+    }
+}
+
+// Signed distance from the edge of a circle of radius r, in 1/16 pixel, for
+// a pixel at squared distance d^2 = r^2 + excess. `inverse` is 2^20 / 2r.
+// d - r = excess / (d + r) is taken as excess / 2r, less its square over 2r
+// to correct for d + r != 2r; within one table step from radius 4 up.
+static inline int32_t edgeDistance(int32_t excess, int32_t inverse) {
+    int32_t edge = (excess * inverse) >> 16;
+    return edge - ((edge * edge * inverse) >> 24);
+}
+
+// Both circles walk the rows of one quadrant, dy = 0..radius, mirroring each
+// row up and down and each pixel left and right. Squared distances are exact
+// integers; only the distance from the edge is scaled by a per-circle
+// reciprocal to index the coverage tables. The span bounds shrink
+// monotonically as dy grows, so they are stepped rather than solved.
 
-    while (x >= y) {
-        float weight = 1.0f - (sqrt((x - radius) * (x - radius) + (y) * (y)) / radius);
-        uint8_t pixelAlpha = (uint8_t)(alpha * weight);
+void CLOCK_HOT_PATH AnimationUtils::drawCircle(int xCenter, int yCenter, int radius, uint16_t color, uint8_t alpha) {
+    if (radius <= 0) {
+        blendPixel(xCenter, yCenter, color, alpha);
+        return;
+    }
+    
+    int32_t rr = radius * radius;
+    int32_t inverse = (1 << 20) / (2 * radius);
+    int low = radius, high = radius + 1;
+    
+    for (int dy = 0; dy <= radius; dy++) {
+        // The ring covers rr - 2r < d^2 < rr + 2r
+        int32_t inside = rr - 2 * radius - dy * dy;
+        int32_t outside = rr + 2 * radius - dy * dy;
+        while (low > 0 && (low - 1) * (low - 1) > inside) low--;
+        while (high >= 0 && high * high >= outside) high--;
         
-        drawPixelWithBlend(x0 + x, y0 + y, color, pixelAlpha);
-        drawPixelWithBlend(x0 + y, y0 + x, color, pixelAlpha);
-        drawPixelWithBlend(x0 - y, y0 + x, color, pixelAlpha);
-        drawPixelWithBlend(x0 - x, y0 + y, color, pixelAlpha);
-        drawPixelWithBlend(x0 - x, y0 - y, color, pixelAlpha);
-        drawPixelWithBlend(x0 - y, y0 - x, color, pixelAlpha);
-        drawPixelWithBlend(x0 + y, y0 - x, color, pixelAlpha);
-        drawPixelWithBlend(x0 + x, y0 - y, color, pixelAlpha);
+        for (int dx = low; dx <= high; dx++) {
+            int32_t edge = edgeDistance(dx * dx + dy * dy - rr, inverse);
+            uint8_t coverage = RING_EDGE[16 + (edge < -16 ? -16 : (edge > 16 ? 16 : edge))];
+            uint8_t pixelAlpha = (alpha * (coverage + 1)) >> 8;
+            
+            blendPixel(xCenter + dx, yCenter + dy, color, pixelAlpha);
+            if (dx) blendPixel(xCenter - dx, yCenter + dy, color, pixelAlpha);
+            if (dy) {
+                blendPixel(xCenter + dx, yCenter - dy, color, pixelAlpha);
+                if (dx) blendPixel(xCenter - dx, yCenter - dy, color, pixelAlpha);
+            }
+        }
+    }
+}
 
-        if (err <= 0) {
-            y += 1;
-            err += 2*y + 1;
+void CLOCK_HOT_PATH AnimationUtils::fillCircle(int xCenter, int yCenter, int radius, uint16_t color, uint8_t alpha) {
+    if (radius <= 0) {
+        blendPixel(xCenter, yCenter, color, alpha);
+        return;
+    }
+    
+    int32_t rr = radius * radius;
+    int32_t inverse = (1 << 20) / (2 * radius);
+    int inner = radius, outer = radius + 1;
+    
+    for (int dy = 0; dy <= radius; dy++) {
+        // Solid to half a pixel inside the edge, d^2 <= rr - r, then
+        // antialiased to half a pixel outside it, d^2 < rr + r
+        int32_t solid = rr - radius - dy * dy;
+        int32_t covered = rr + radius - dy * dy;
+        while (inner >= 0 && inner * inner > solid) inner--;
+        while (outer >= 0 && outer * outer >= covered) outer--;
+        
+        for (int side = 0; side < (dy ? 2 : 1); side++) {
+            int y = side ? yCenter - dy : yCenter + dy;
+            if (inner >= 0) {
+                blendSpan(y, xCenter - inner, xCenter + inner + 1, color, alpha);
+            }
+            for (int dx = inner + 1; dx <= outer; dx++) {
+                int32_t edge = edgeDistance(dx * dx + dy * dy - rr, inverse);
+                uint8_t coverage = FILL_EDGE[8 + (edge < -8 ? -8 : (edge > 8 ? 8 : edge))];
+                uint8_t pixelAlpha = (alpha * (coverage + 1)) >> 8;
+                
+                blendPixel(xCenter + dx, y, color, pixelAlpha);
+                if (dx) blendPixel(xCenter - dx, y, color, pixelAlpha);
+            }
         }
-        if (err > 0) {
-            x -= 1;
-            err -= 2*x + 1;
+    }
+}
+
+// Line primitives work in 1/16 pixel, with integer coordinates at pixel
+// centres. Each one picks its blend target once and writes pixels by index.
+struct LinePainter {
+    uint16_t* target;
+    uint32_t* accumulation;
+    uint16_t color;
+    uint32_t packed;
+    
+    LinePainter(uint32_t* accumulation, uint16_t color)
+        : target(display.getRenderTarget()), accumulation(accumulation), color(color),
+          packed(Accumulation::from565(color)) {}
+    
+    inline void blend(int index, uint8_t alpha) {
+        if (!alpha) return;
+        if (accumulation) {
+            accumulation[index] = Accumulation::blend(accumulation[index], packed, alpha + (alpha >> 7));
+        } else {
+            target[index] = alpha == 255 ? color : blend565(target[index], color, alpha);
+        }
+    }
+    
+    // [x0, x1) of row y, already clipped
+    inline void span(int y, int x0, int x1, uint8_t alpha) {
+        for (int index = y * DISPLAY_WIDTH + x0; index < y * DISPLAY_WIDTH + x1; index++) {
+            blend(index, alpha);
+        }
+    }
+};
+
+// Xiaolin Wu's line: one pixel per step along the major axis, split between
+// the two pixels either side of the exact minor position. The major range
+// is clipped once; the minor position only needs an unsigned compare.
+// skipFirst and skipLast leave out the end pixels another segment has drawn.
+static void CLOCK_HOT_PATH wuLine(LinePainter& painter, int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                                  uint8_t alpha, bool skipFirst, bool skipLast) {
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+        int32_t t = x0; x0 = y0; y0 = t;
+        t = x1; x1 = y1; y1 = t;
+    }
+    
+    // Draw from the lower major coordinate; the skipped ends move with it
+    if (x0 > x1) {
+        int32_t t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+        bool skip = skipFirst; skipFirst = skipLast; skipLast = skip;
+    }
+    
+    const int majorSize = steep ? DISPLAY_HEIGHT : DISPLAY_WIDTH;
+    const int minorSize = steep ? DISPLAY_WIDTH : DISPLAY_HEIGHT;
+    const int majorStep = steep ? DISPLAY_WIDTH : 1;
+    const int minorStep = steep ? 1 : DISPLAY_WIDTH;
+    
+    // Whole line off one side of the display
+    if ((max(y0, y1) >> 4) < -1 || (min(y0, y1) >> 4) >= minorSize) return;
+    
+    int start = (x0 + 8) >> 4;
+    int end = (x1 + 8) >> 4;
+    if (skipFirst) start++;
+    if (skipLast) end--;
+    
+    // Minor position per major step, and at the first pixel, in 16.16
+    int32_t gradient = x1 == x0 ? 0 : (int32_t)(((int64_t)(y1 - y0) << 16) / (x1 - x0));
+    int first = max(start, 0);
+    int last = min(end, majorSize - 1);
+    int32_t minor = (y0 << 12) + (int32_t)(((int64_t)(first * 16 - x0) * gradient) >> 4);
+    
+    for (int major = first; major <= last; major++, minor += gradient) {
+        int low = minor >> 16;
+        uint8_t fraction = (minor >> 8) & 0xFF;
+        int index = major * majorStep + low * minorStep;
+        if ((unsigned)low < (unsigned)minorSize) {
+            painter.blend(index, (alpha * (256 - fraction)) >> 8);
+        }
+        if ((unsigned)(low + 1) < (unsigned)minorSize) {
+            painter.blend(index + minorStep, (alpha * fraction) >> 8);
         }
     }
 }
 
-void AnimationUtils::fillCircle(float xCenter, float yCenter, float radius, uint16_t color, uint8_t alpha) {
-    int x0 = round(xCenter);
-    int y0 = round(yCenter);
-    float radiusSquared = radius * radius;
+// Edge of a convex polygon where it crosses height y (1/16 pixel), as the
+// lowest and highest x of the edges spanning that height
+static bool convexSpanAt(const int32_t* xs, const int32_t* ys, int count, int32_t y, int32_t* left, int32_t* right) {
+    bool found = false;
+    for (int i = 0; i < count; i++) {
+        int j = i + 1 == count ? 0 : i + 1;
+        int32_t ya = ys[i], yb = ys[j];
+        if ((y < ya && y < yb) || (y > ya && y > yb)) continue;
+        
+        int32_t x = ya == yb ? min(xs[i], xs[j]) :
+            xs[i] + (int32_t)((int64_t)(xs[j] - xs[i]) * (y - ya) / (yb - ya));
+        int32_t x2 = ya == yb ? max(xs[i], xs[j]) : x;
+        if (!found) {
+            *left = x;
+            *right = x2;
+            found = true;
+        } else {
+            *left = min(*left, x);
+            *right = max(*right, x2);
+        }
+    }
+    return found;
+}
 
-    for (float dy = -radius; dy <= radius; dy += 1.0f) {
-        float dx = sqrt(radiusSquared - dy * dy);
-        int y = round(y0 + dy);
+// Quad around the segment (x0, y0)-(x1, y1), all in 1/16 pixel. A pixel is
+// covered by how far its centre is inside the long sides, times how far it
+// is inside the ends. Each is a linear ramp as wide as the pixel measured
+// across that edge, |cos| + |sin| of the line's angle, which sums to the
+// line's exact width and length at any angle. Distances are kept in units
+// of that ramp so a pixel needs no divide. Rows are clipped once and each
+// is scanned over the quad grown by the ramp.
+static void CLOCK_HOT_PATH thickSegment(LinePainter& painter, int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                                        int width, uint8_t alpha) {
+    int32_t dx = x1 - x0, dy = y1 - y0;
+    float length = sqrtf((float)dx * dx + (float)dy * dy);
+    if (length < 1) return;
+    
+    // Direction over the ramp width in 1/65536, so |vx| + |vy| = 1; half the
+    // width and the length in ramp widths/256
+    float manhattan = (float)(abs(dx) + abs(dy));
+    int32_t vx = (int32_t)lroundf(dx * 65536.0f / manhattan);
+    int32_t vy = (int32_t)lroundf(dy * 65536.0f / manhattan);
+    int32_t half = (int32_t)lroundf(width * 128 * length / manhattan);
+    int32_t reach = (int32_t)lroundf(length * length * 16 / manhattan);
+    
+    // Grown by half a ramp, at most 0.71 pixel, and some rounding
+    int32_t ux = (int32_t)lroundf(dx * 13 / length), uy = (int32_t)lroundf(dy * 13 / length);
+    int32_t nx = (int32_t)lroundf(-dy * (width * 8 + 13) / length);
+    int32_t ny = (int32_t)lroundf(dx * (width * 8 + 13) / length);
+    const int32_t xs[4] = {x0 - ux + nx, x1 + ux + nx, x1 + ux - nx, x0 - ux - nx};
+    const int32_t ys[4] = {y0 - uy + ny, y1 + uy + ny, y1 + uy - ny, y0 - uy - ny};
+    
+    int32_t top = min(min(ys[0], ys[1]), min(ys[2], ys[3]));
+    int32_t bottom = max(max(ys[0], ys[1]), max(ys[2], ys[3]));
+    int firstRow = max(0, (top + 15) >> 4);
+    int lastRow = min(DISPLAY_HEIGHT - 1, bottom >> 4);
+    
+    for (int y = firstRow; y <= lastRow; y++) {
+        int32_t left, right;
+        if (!convexSpanAt(xs, ys, 4, y * 16, &left, &right)) continue;
+        int xa = max(0, (left + 15) >> 4);
+        int xb = min(DISPLAY_WIDTH - 1, right >> 4);
+        if (xa > xb) continue;
         
-        for (float x = -dx; x <= dx; x += 1.0f) {
-            int xPos = round(x0 + x);
-            float distanceFromCenter = sqrt(x * x + dy * dy);
-            float weight = 1.0f - (distanceFromCenter / radius);
-            weight = max(0.0f, min(1.0f, weight));
+        // Signed distances of the pixel centre across and along the line,
+        // in ramp widths/256 with 12 more fraction bits, stepped along the row
+        int64_t px = xa * 16 - x0, py = y * 16 - y0;
+        int64_t across = px * vy - py * vx;
+        int64_t along = px * vx + py * vy;
+        
+        for (int x = xa; x <= xb; x++, across += vy * 16, along += vx * 16) {
+            int32_t side = (int32_t)(across >> 12);
+            int32_t t = (int32_t)(along >> 12);
+            int32_t inSides = half + 128 - (side < 0 ? -side : side);
+            int32_t inEnds = min(t, reach - t) + 128;
+            if (inSides <= 0 || inEnds <= 0) continue;
             
-            uint8_t pixelAlpha = (uint8_t)(alpha * weight);
-            drawPixelWithBlend(xPos, y, color, pixelAlpha);
+            int32_t coverage = (min(inSides, (int32_t)256) * min(inEnds, (int32_t)256)) >> 8;
+            painter.blend(y * DISPLAY_WIDTH + x, (alpha * coverage) >> 8);
         }
     }
-}
\ No newline at end of file
+}
+
+// At width 1 `joinedStart` and `joinedEnd` say which ends are shared with
+// another segment of the same polyline or arc, which draws them instead.
+// Wider segments are independent quads.
+static void segment(LinePainter& painter, int32_t x0, int32_t y0, int32_t x1, int32_t y1, int width, uint8_t alpha,
+                    bool joinedStart, bool joinedEnd) {
+    if (width <= 1) {
+        wuLine(painter, x0, y0, x1, y1, alpha, joinedStart, joinedEnd);
+    } else {
+        thickSegment(painter, x0, y0, x1, y1, width, alpha);
+    }
+}
+
+void AnimationUtils::drawLine(int x0, int y0, int x1, int y1, uint16_t color, uint8_t alpha, int width) {
+    LinePainter painter(accumulation, color);
+    segment(painter, x0 << 4, y0 << 4, x1 << 4, y1 << 4, width, alpha, false, false);
+}
+
+void AnimationUtils::drawPolyline(const int16_t* points, int count, uint16_t color, uint8_t alpha, int width, bool closed) {
+    LinePainter painter(accumulation, color);
+    for (int i = 1; i < count; i++) {
+        // Each joint belongs to the segment ending there, so it isn't blended twice
+        segment(painter, points[2 * i - 2] << 4, points[2 * i - 1] << 4,
+                points[2 * i] << 4, points[2 * i + 1] << 4, width, alpha, i > 1, false);
+    }
+    if (closed && count > 2) {
+        // Both ends of the closing segment are joints drawn already
+        segment(painter, points[2 * count - 2] << 4, points[2 * count - 1] << 4,
+                points[0] << 4, points[1] << 4, width, alpha, true, true);
+    }
+}
+
+void AnimationUtils::drawArc(int xCenter, int yCenter, int radius, uint16_t startAngle, uint16_t sweep,
+                             uint16_t color, uint8_t alpha, int width) {
+    if (radius <= 0 || !sweep) return;
+    
+    // Chords about three pixels long
+    int32_t arcLength = ((int32_t)radius * sweep) / 10430;  // 65536 / 2π
+    int segments = max(2, (int)(arcLength / 3));
+    
+    LinePainter painter(accumulation, color);
+    int32_t cx = xCenter << 4, cy = yCenter << 4;
+    int32_t px = cx + ((cos16(startAngle) * radius) >> 11);
+    int32_t py = cy + ((sin16(startAngle) * radius) >> 11);
+    for (int i = 1; i <= segments; i++) {
+        uint16_t angle = startAngle + (uint16_t)(((uint32_t)sweep * i) / segments);
+        int32_t x = cx + ((cos16(angle) * radius) >> 11);
+        int32_t y = cy + ((sin16(angle) * radius) >> 11);
+        segment(painter, px, py, x, y, width, alpha, i > 1, false);
+        px = x;
+        py = y;
+    }
+}
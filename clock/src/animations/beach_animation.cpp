@@ -1,48 +1,69 @@
 #include "animations_modules.h"
 #include "animation_utils.h"
 #include "display.h"
+#include "alpha_sprites.h"
 #include <FastLED.h>
 
 namespace BeachAnimation {
+    const uint8_t SEA_LUT_SIZE = 64;
+    
     struct State {
-        uint32_t frameCount = 0;
-        bool initialized = false;
+        uint16_t background[DISPLAY_HEIGHT]; // Sky, gap and dry sand; every row is one colour
+        uint16_t sea[SEA_LUT_SIZE];          // Sea colour from its top edge down
     };
+    static_assert(sizeof(State) <= STATE_BUDGET, "State has outgrown its budget in ANIMATION_LIST");
     
-    static State state;
+    // Scene layout as fractions of the panel, rounded to whole rows
+    const int SKY_HEIGHT = (DISPLAY_HEIGHT * 2 + 2) / 5;          // 40%
+    const int DRY_SAND_TOP = (DISPLAY_HEIGHT * 13 + 10) / 20;     // 65%
+    const int WET_SAND_HEIGHT = DISPLAY_HEIGHT * 3 / 8;           // 37.5%
     
-    void init() {
-        state.frameCount = 0;
-        state.initialized = true;
-    }
+    static ArenaState<State> state;
     
-    void render() {
-        if (!state.initialized) {
-            init();
-        }
-
-        display.clearData();
-        
-        state.frameCount++;
-        float time = state.frameCount * 0.05f;  // Matches HTML timing
+    // Sky from #037ccb (deep sky blue) to #82ccef (light sky blue)
+    static const GradientStop SKY_STOPS[] = {
+        {0, 0x03, 0x7c, 0xcb},
+        {255, 0x82, 0xcc, 0xef}
+    };
+    
+    // Sea gradient (matches CSS)
+    static const GradientStop SEA_STOPS[] = {
+        {0, 8, 122, 193},
+        {64, 18, 156, 192},
+        {128, 42, 212, 229},
+        {191, 150, 233, 239},
+        {255, 222, 236, 211}
+    };
+    
+    void init(void* memory) {
+        state.construct(memory);
         
-        // Sky gradient (40% of height = 25.6px, but we'll use 26px)
-        for (int y = 0; y < 26; y++) {
-            for (int x = 0; x < DISPLAY_WIDTH; x++) {
-                // Gradient from #037ccb (deep sky blue) to #82ccef (light sky blue)
-                uint8_t r = 0x03 + ((y * (0x82 - 0x03)) / 26);
-                uint8_t g = 0x7c + ((y * (0xcc - 0x7c)) / 26);
-                uint8_t b = 0xcb + ((y * (0xef - 0xcb)) / 26);
-                display.drawPixelRGB888(x, y, r, g, b);
-            }
+        // The static layers: sky gradient, black until the sand, dry sand
+        AnimationUtils::bakeGradient(SKY_STOPS, 2, state->background, SKY_HEIGHT);
+        for (int y = SKY_HEIGHT; y < DISPLAY_HEIGHT; y++) {
+            state->background[y] = y < DRY_SAND_TOP ? 0 : AnimationUtils::rgb888To565(0xfd, 0xf1, 0xd7);  // #fdf1d7 dry sand
         }
         
-        // Dry sand background (from 65% = 41.6px to bottom, we'll use 42px)
-        for (int y = 42; y < DISPLAY_HEIGHT; y++) {
-            for (int x = 0; x < DISPLAY_WIDTH; x++) {
-                display.drawPixelRGB888(x, y, 0xfd, 0xf1, 0xd7);  // #fdf1d7 dry sand
+        AnimationUtils::bakeGradient(SEA_STOPS, 5, state->sea, SEA_LUT_SIZE);
+    }
+    
+    // Blend `color` over [x0, x1) of row y, where the row is one colour
+    // before split0, another up to split1 and a third after it, so only one
+    // pixel of each run is blended and the result filled across the run.
+    static void blendRuns(int y, int x0, int x1, int split0, int split1, uint8_t r, uint8_t g, uint8_t b, uint8_t alpha) {
+        const int edges[4] = {x0, max(x0, min(x1, split0)), max(x0, min(x1, split1)), x1};
+        for (int i = 0; i < 3; i++) {
+            if (edges[i] < edges[i + 1]) {
+                AnimationUtils::fillSpan(y, edges[i], edges[i + 1], AnimationUtils::alphaBlend(edges[i], y, r, g, b, alpha));
             }
         }
+    }
+    
+    void CLOCK_HOT_PATH renderAt(uint32_t frame) {
+        float time = frame * 0.05f;  // Matches HTML timing
+        
+        // Static layers, one colour per row
+        AnimationUtils::fillRowsFromLut(0, DISPLAY_HEIGHT, state->background);
         
         // Wave animation (matches CSS waveanim keyframes)
         float waveScale = 1.0f;
@@ -60,49 +81,26 @@ namespace BeachAnimation {
         }
         
         // Sea parameters (30% height scaled, 200% width, -50% left, top at 40%)
-        int seaHeight = (int)(19.2f * waveScale);  // 30% of 64px scaled
-        int seaWidth = 256;   // 200% of 128px
-        int seaLeft = -64;    // -50% of 128px
-        int seaTop = 26;      // 40% of 64px (approximately)
+        int seaHeight = (int)(DISPLAY_HEIGHT * 0.3f * waveScale);
+        int seaWidth = DISPLAY_WIDTH * 2;
+        int seaLeft = -DISPLAY_WIDTH / 2;
+        int seaTop = SKY_HEIGHT;
+        float centerX = seaLeft + seaWidth / 2.0f;
         
-        // Draw curved sea using simple ellipse approximation
-        for (int y = seaTop; y < seaTop + seaHeight && y < DISPLAY_HEIGHT; y++) {
-            for (int x = max(0, seaLeft); x < min(DISPLAY_WIDTH, seaLeft + seaWidth); x++) {
-                // Check if point is within elliptical sea area
-                float centerX = seaLeft + seaWidth / 2.0f;
-                float centerY = seaTop + seaHeight / 2.0f;
-                float dx = (x - centerX) / (seaWidth / 2.0f);
-                float dy = (y - centerY) / (seaHeight / 2.0f);
-                
-                if (dx * dx + dy * dy <= 1.0f) {
-                    // Sea gradient (matches CSS)
-                    float gradientPos = (float)(y - seaTop) / seaHeight;
-                    uint8_t r, g, b;
-                    
-                    if (gradientPos <= 0.25f) {
-                        float t = gradientPos / 0.25f;
-                        r = 8 + (uint8_t)(t * (18 - 8));
-                        g = 122 + (uint8_t)(t * (156 - 122));
-                        b = 193 + (uint8_t)(t * (192 - 193));
-                    } else if (gradientPos <= 0.5f) {
-                        float t = (gradientPos - 0.25f) / 0.25f;
-                        r = 18 + (uint8_t)(t * (42 - 18));
-                        g = 156 + (uint8_t)(t * (212 - 156));
-                        b = 192 + (uint8_t)(t * (229 - 192));
-                    } else if (gradientPos <= 0.75f) {
-                        float t = (gradientPos - 0.5f) / 0.25f;
-                        r = 42 + (uint8_t)(t * (150 - 42));
-                        g = 212 + (uint8_t)(t * (233 - 212));
-                        b = 229 + (uint8_t)(t * (239 - 229));
-                    } else {
-                        float t = (gradientPos - 0.75f) / 0.25f;
-                        r = 150 + (uint8_t)(t * (222 - 150));
-                        g = 233 + (uint8_t)(t * (236 - 233));
-                        b = 239 + (uint8_t)(t * (211 - 239));
-                    }
-                    
-                    display.drawPixelRGB888(x, y, r, g, b);
-                }
+        // Curved sea: a whole ellipse filling rows seaTop to seaTop + seaHeight,
+        // one span per row. The spans are kept to split the wet sand rows
+        // where they cross the sea.
+        int seaStart[DISPLAY_HEIGHT];
+        int seaEnd[DISPLAY_HEIGHT];
+        float centerY = seaTop + seaHeight / 2.0f;
+        for (int y = seaTop; y < DISPLAY_HEIGHT; y++) {
+            seaStart[y] = seaEnd[y] = 0;
+            if (y >= seaTop + seaHeight) continue;
+            
+            float dy = (y - centerY) / (seaHeight / 2.0f);
+            if (AnimationUtils::ellipseSpan(centerX, seaWidth / 2.0f, dy, &seaStart[y], &seaEnd[y])) {
+                // The sea colour only depends on the row
+                AnimationUtils::fillSpan(y, seaStart[y], seaEnd[y], state->sea[(y - seaTop) * SEA_LUT_SIZE / seaHeight]);
             }
         }
         
@@ -114,54 +112,41 @@ namespace BeachAnimation {
             wetSandOpacity = 0.4f - ((cyclePosition - 0.35f) / 0.65f) * 0.2f;
         }
         
-        // Wet sand (37.5% height = 24px)
-        int wetSandHeight = 24;
+        // Wet sand color #ecc075 blended with whatever is under it, which is
+        // the sea inside its span and the background row outside it
+        int wetSandHeight = WET_SAND_HEIGHT;
+        float wetCenterY = seaTop + wetSandHeight / 2.0f;
+        uint8_t alpha = (uint8_t)(wetSandOpacity * 255);
         for (int y = seaTop; y < seaTop + wetSandHeight && y < DISPLAY_HEIGHT; y++) {
-            for (int x = max(0, seaLeft); x < min(DISPLAY_WIDTH, seaLeft + seaWidth); x++) {
-                float centerX = seaLeft + seaWidth / 2.0f;
-                float centerY = seaTop + wetSandHeight / 2.0f;
-                float dx = (x - centerX) / (seaWidth / 2.0f);
-                float dy = (y - centerY) / (wetSandHeight / 2.0f);
-                
-                if (dx * dx + dy * dy <= 1.0f) {
-                    // Wet sand color #ecc075 blended with existing
-                    uint8_t wetR = 0xec;
-                    uint8_t wetG = 0xc0;
-                    uint8_t wetB = 0x75;
-                    uint8_t alpha = (uint8_t)(wetSandOpacity * 255);
-                    AnimationUtils::drawPixelWithBlend(x, y, AnimationUtils::rgb888To565(wetR, wetG, wetB), alpha);
-                }
+            float dy = (y - wetCenterY) / (wetSandHeight / 2.0f);
+            int x0, x1;
+            if (AnimationUtils::ellipseSpan(centerX, seaWidth / 2.0f, dy, &x0, &x1)) {
+                blendRuns(y, x0, x1, seaStart[y], seaEnd[y], 0xec, 0xc0, 0x75, alpha);
             }
         }
         
         // Seabirds in the distance
-        int birdX = (int)((time * 10) + 40) % 150 - 10;
-        int birdY = 8 + (int)(sin16(time * 32768) / 65535.0f * 6);
-        
-        uint16_t birdColor = AnimationUtils::rgb888To565(0, 0, 0);  // Black
+        int birdX = (int)((time * 10) + 40) % (DISPLAY_WIDTH + 22) - 10;
+        int birdY = DISPLAY_HEIGHT / 8 + (int)(sin16(time * 32768) / 65535.0f * 6);
         
-        // Larger bird shape
-        // Left wing
-        display.drawPixel(birdX - 3, birdY, birdColor);
-        display.drawPixel(birdX - 2, birdY, birdColor);
-        display.drawPixel(birdX - 2, birdY - 1, birdColor);
-        
-        // Body/head
-        display.drawPixel(birdX, birdY - 1, birdColor);
-        display.drawPixel(birdX, birdY, birdColor);
-        display.drawPixel(birdX + 1, birdY, birdColor);
-        
-        // Right wing
-        display.drawPixel(birdX + 2, birdY - 1, birdColor);
-        display.drawPixel(birdX + 2, birdY, birdColor);
-        display.drawPixel(birdX + 3, birdY, birdColor);
-        
-        // Tail
-        display.drawPixel(birdX + 1, birdY + 1, birdColor);
-        display.drawPixel(birdX + 2, birdY + 1, birdColor);
+        // The bird sprite is centred on its body
+        AnimationUtils::drawSprite(birdX - 3, birdY - 1, SEABIRD_SPRITE);
     }
     
-    const char* getName() {
-        return "Beach";
+    void teardown() {
+        state.destroy();
     }
+    
+    constexpr AnimationDescriptor descriptor = {
+        "Beach",
+        nullptr,
+        init,
+        renderAt,
+        teardown,
+        true,
+        false,
+        AA_BOX_3X3,
+        60,
+        sizeof(State)
+    };
 }
\ No newline at end of file
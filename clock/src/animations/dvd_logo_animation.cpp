@@ -1,17 +1,31 @@
 #include "animations_modules.h"
 #include "animation_utils.h"
 #include "dvd_logo.h"
+#include "span_sprites.h"
 #include <Arduino.h>
 
 namespace DVDLogoAnimation {
-    // DVD logo position and velocity
-    float logoX = 10.0;
-    float logoY = 10.0;
-    float velocityX = 1.5;
-    float velocityY = 1.0;
+    // Starting position (in half pixels), direction and color; everything
+    // else is derived from the frame index.
+    struct State {
+        int32_t startX = 0;
+        int32_t startY = 0;
+        bool reverseX = false;
+        bool reverseY = false;
+        uint8_t startColorIndex = 0;
+    };
+    static_assert(sizeof(State) <= STATE_BUDGET, "State has outgrown its budget in ANIMATION_LIST");
+    
+    // Positions are tracked in half pixels so the 1.5px/frame horizontal
+    // speed stays integral, which lets any frame be computed in closed form.
+    const int32_t TRAVEL_X = 2 * (DISPLAY_WIDTH - dvdLogoImageWidth);
+    const int32_t TRAVEL_Y = 2 * (DISPLAY_HEIGHT - dvdLogoImageHeight);
+    const int32_t SPEED_X = 3; // 1.5px per frame
+    const int32_t SPEED_Y = 2; // 1.0px per frame
+    
+    static ArenaState<State> state;
     
     // Color cycling
-    uint8_t currentColorIndex = 0;
     const uint16_t colors[] = {
         display.color565(0xFF,00,00), // Red
         display.color565(0x00,0xFF,00), // Green
@@ -24,61 +38,64 @@ namespace DVDLogoAnimation {
     };
     const uint8_t numColors = sizeof(colors) / sizeof(colors[0]);
     
-    void init() {
+    // Position after `frame` steps of bouncing between 0 and `travel`,
+    // along with the number of edge hits on the way.
+    static int32_t bounce(int32_t start, int32_t speed, int32_t travel, bool reverse,
+                          uint32_t frame, uint32_t* hits) {
+        // Moving backwards is the mirror image of moving forwards
+        uint32_t distance = (uint32_t)(reverse ? travel - start : start) + (uint32_t)speed * frame;
+        *hits = distance / travel;
+        
+        int32_t folded = distance % (2 * travel);
+        if (folded > travel) {
+            folded = 2 * travel - folded;
+        }
+        return reverse ? travel - folded : folded;
+    }
+    
+    void init(void* memory) {
+        state.construct(memory);
+        
         // Initialize position to center-ish
-        logoX = (DISPLAY_WIDTH - dvdLogoImageWidth) / 2.0;
-        logoY = (DISPLAY_HEIGHT - dvdLogoImageHeight) / 2.0;
+        state->startX = TRAVEL_X / 2;
+        state->startY = TRAVEL_Y / 2;
         
         // Random initial velocity direction
-        velocityX = (random(2) == 0) ? 1.5 : -1.5;
-        velocityY = (random(2) == 0) ? 1.0 : -1.0;
+        state->reverseX = random(2) == 0;
+        state->reverseY = random(2) == 0;
         
         // Random starting color
-        currentColorIndex = random(numColors);
+        state->startColorIndex = random(numColors);
     }
     
-    void render() {
+    void renderAt(uint32_t frame) {
         display.clearData();
-
-        // Update position
-        logoX += velocityX;
-        logoY += velocityY;
-        
-        // Check for collisions with edges and bounce
-        bool colorChanged = false;
-        
-        // Left/right edge collision
-        if (logoX <= 0) {
-            logoX = 0;
-            velocityX = -velocityX;
-            colorChanged = true;
-        } else if (logoX >= DISPLAY_WIDTH - dvdLogoImageWidth) {
-            logoX = DISPLAY_WIDTH - dvdLogoImageWidth;
-            velocityX = -velocityX;
-            colorChanged = true;
-        }
         
-        // Top/bottom edge collision
-        if (logoY <= 0) {
-            logoY = 0;
-            velocityY = -velocityY;
-            colorChanged = true;
-        } else if (logoY >= DISPLAY_HEIGHT - dvdLogoImageHeight) {
-            logoY = DISPLAY_HEIGHT - dvdLogoImageHeight;
-            velocityY = -velocityY;
-            colorChanged = true;
-        }
+        uint32_t hitsX, hitsY;
+        int32_t logoX = bounce(state->startX, SPEED_X, TRAVEL_X, state->reverseX, frame, &hitsX);
+        int32_t logoY = bounce(state->startY, SPEED_Y, TRAVEL_Y, state->reverseY, frame, &hitsY);
         
-        // Change color when hitting an edge
-        if (colorChanged) {
-            currentColorIndex = (currentColorIndex + 1) % numColors;
-        }
+        // Change color every time an edge is hit
+        uint8_t colorIndex = (state->startColorIndex + hitsX + hitsY) % numColors;
         
-        // Draw the DVD logo bitmap with current color
-        AnimationUtils::drawBitmapTransparent((int)logoX, (int)logoY, dvd_logo_bitmap, dvdLogoImageWidth, dvdLogoImageHeight, colors[currentColorIndex]);
+        // Draw the DVD logo (its spans, see scripts/sprite_spans.py) with current color
+        AnimationUtils::drawSprite(logoX / 2, logoY / 2, DVD_LOGO_SPRITE, colors[colorIndex]);
     }
     
-    const char* getName() {
-        return "DVD Logo";
+    void teardown() {
+        state.destroy();
     }
+    
+    constexpr AnimationDescriptor descriptor = {
+        "DVD Logo",
+        nullptr,
+        init,
+        renderAt,
+        teardown,
+        true,
+        false,
+        AA_BOX_3X3,
+        60,
+        sizeof(State)
+    };
 }
\ No newline at end of file
@@ -1,54 +1,132 @@
 #include "animations_modules.h"
 #include "animation_utils.h"
 #include "display.h"
-#include <algorithm>
-#include <FastLED.h>
 
 namespace FireAnimation {
-    // Private state - completely contained within this namespace
     struct State {
-        uint32_t frameCount = 0;
-        bool initialized = false;
+        uint16_t palette[256];   // Colour for each heat level
+        uint8_t* heat = nullptr; // DISPLAY_WIDTH x DISPLAY_HEIGHT, from the heap
+        uint32_t seed = 1;
     };
+    static_assert(sizeof(State) <= STATE_BUDGET, "State has outgrown its budget in ANIMATION_LIST");
     
-    static State state;
+    static ArenaState<State> state;
+    static Settings settings;
     
-    void init() {
-        state.frameCount = 0;
-        state.initialized = true;
+    // Heat from cold to white hot
+    static const GradientStop HEAT_STOPS[] = {
+        {0, 0, 0, 0},
+        {24, 0, 0, 0},
+        {96, 200, 0, 0},
+        {160, 255, 120, 0},
+        {224, 255, 220, 40},
+        {255, 255, 255, 200}
+    };
+    
+    void setSettings(const Settings& newSettings) {
+        settings = newSettings;
+        if (settings.flameHeight < 10) settings.flameHeight = 10;
+        if (settings.flameHeight > 100) settings.flameHeight = 100;
+    }
+    
+    const Settings& getSettings() {
+        return settings;
+    }
+    
+    // xorshift32; one call gives the random bits for one pixel
+    static inline uint32_t nextRandom(uint32_t& seed) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        return seed;
     }
     
-    void render() {
-        if (!state.initialized) {
-            init();
+    void init(void* memory) {
+        state.construct(memory);
+        
+        // On the heap rather than in State, so the biggest heat map doesn't
+        // set the size of every animation's state slot
+        state->heat = (uint8_t*)calloc(DISPLAY_WIDTH * DISPLAY_HEIGHT, 1);
+        
+        AnimationUtils::bakeGradient(HEAT_STOPS, 6, state->palette, 256);
+        state->seed = random(1, 0x7FFFFFFF);
+    }
+    
+    // Heat of a cell from the three cells below it and the one below those,
+    // less `cool` (1/16ths) with random rounding
+    static inline uint8_t rise(uint16_t sum, uint32_t bits, uint16_t base, uint8_t jitter) {
+        uint16_t cool = (base + (((bits & 0xFF) * jitter) >> 8) + ((bits >> 8) & 15)) >> 4;
+        uint16_t heat = sum >> 2;
+        return heat > cool ? heat - cool : 0;
+    }
+    
+    void CLOCK_HOT_PATH render() {
+        uint8_t* heat = state->heat;
+        if (!heat) {
+            display.clearData();
+            return;
         }
         
-        state.frameCount++;
-
-        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
-            for (int x = 0; x < DISPLAY_WIDTH; x++) {
-                // Convert coordinates to FastLED angles with fixed-point math
-                int16_t noiseX = ((x * 10430) / 18 + (state.frameCount * (0.2 * 10430))); 
-                int16_t noiseY = ((y * 10430) / 12 + (state.frameCount * (0.15 * 10430))); 
-                
-                // Use FastLED's 16-bit sine approximations
-                int32_t noise = ((int32_t)sin16(noiseX) * cos16(noiseY)) >> 15;
-                
-                // Fixed-point arithmetic for flame calculations (8-bit fraction)
-                int16_t flameHeight = (y + ((noise * 8) >> 15));
-                int16_t flame = (flameHeight << 8) / 64;
-                
-                if (flame > 25) { // 0.1 in fixed point (25 = 0.1 * 256)
-                    uint8_t r = min(255, (flame * 240) >> 8);
-                    uint8_t g = min(200, max(0, ((flame - 77) * 350) >> 8)); // 77 = 0.3 * 256
-                    uint8_t b = max(0, ((flame - 179) * 600) >> 8); // 179 = 0.7 * 256
-                    AnimationUtils::drawPixelWithBlend(x, y, AnimationUtils::rgb888To565(r, g, b));
-                }
+        uint8_t* indices = display.getIndexedTarget();
+        uint32_t seed = state->seed;
+        
+        // Cooling per row, in 1/16ths, that lets a full spark climb flameHeight
+        // percent of the panel on average. The random part (half of jitter,
+        // and the rounding) is taken out of the fixed part.
+        uint8_t jitter = settings.cooling;
+        int flameRows = max(1, DISPLAY_HEIGHT * settings.flameHeight / 100);
+        int fixedCooling = 255 * 16 / flameRows - jitter / 2 - 8;
+        uint16_t base = (uint16_t)(fixedCooling < 0 ? 0 : (fixedCooling > 4095 ? 4095 : fixedCooling));
+        
+        // Rows rise in place from the top down, so every row still reads the
+        // previous frame's heat underneath it
+        for (int y = 0; y < DISPLAY_HEIGHT - 1; y++) {
+            uint8_t* row = heat + y * DISPLAY_WIDTH;
+            const uint8_t* below = row + DISPLAY_WIDTH;
+            const uint8_t* below2 = y < DISPLAY_HEIGHT - 2 ? below + DISPLAY_WIDTH : below;
+            
+            // Edge columns reuse their own heat for the missing neighbour
+            row[0] = rise(below[0] * 2 + below[1] + below2[0], nextRandom(seed), base, jitter);
+            for (int x = 1; x < DISPLAY_WIDTH - 1; x++) {
+                row[x] = rise(below[x - 1] + below[x] + below[x + 1] + below2[x], nextRandom(seed), base, jitter);
             }
+            int last = DISPLAY_WIDTH - 1;
+            row[last] = rise(below[last - 1] + below[last] * 2 + below2[last], nextRandom(seed), base, jitter);
+            
+            memcpy(indices + y * DISPLAY_WIDTH, row, DISPLAY_WIDTH);
+        }
+        
+        // Sparks along the bottom edge; cells without one die down
+        uint8_t* bottom = heat + (DISPLAY_HEIGHT - 1) * DISPLAY_WIDTH;
+        for (int x = 0; x < DISPLAY_WIDTH; x++) {
+            uint32_t bits = nextRandom(seed);
+            uint8_t spark = (bits & 0xFF) < settings.sparkRate ? 160 + ((bits >> 8) % 96) : 0;
+            uint8_t embers = (bottom[x] * 3) >> 2;
+            bottom[x] = spark > embers ? spark : embers;
         }
+        memcpy(indices + (DISPLAY_HEIGHT - 1) * DISPLAY_WIDTH, bottom, DISPLAY_WIDTH);
+        
+        state->seed = seed;
+        display.resolveIndexed(state->palette);
     }
     
-    const char* getName() {
-        return "Fire";
+    void teardown() {
+        if (state.constructed()) {
+            free(state->heat);
+        }
+        state.destroy();
     }
-}
\ No newline at end of file
+    
+    constexpr AnimationDescriptor descriptor = {
+        "Fire",
+        nullptr,
+        init,
+        renderNext<render>,
+        teardown,
+        false,
+        true,
+        AA_BOX_3X3,
+        60,
+        sizeof(State)
+    };
+}
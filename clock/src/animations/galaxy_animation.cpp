@@ -4,67 +4,173 @@
 #include <cmath>
 
 namespace GalaxyAnimation {
+    // Points along one spiral arm, 0.03 radians apart over two turns
+    const uint16_t SPIRAL_CAPACITY = 424;
+    
+    struct SpiralPoint {
+        int16_t x, y;   // Offset from the centre before rotation, 10.6 fixed point
+    };
+    
     struct State {
         uint32_t frameCount = 0;
-        bool initialized = false;
+        uint32_t* accumulation = nullptr; // Trails, when there is room for them
+        SpiralPoint spiral[SPIRAL_CAPACITY];
+        uint16_t spiralPoints = 0;
+        float spiralAngle = 0;   // Where prepare() carries on building the arm
     };
+    static_assert(sizeof(State) <= STATE_BUDGET, "State has outgrown its budget in ANIMATION_LIST");
+    
+    // Spiral radius relative to the 64 pixel tall panel it was designed for
+    const float SCALE = DISPLAY_HEIGHT / 64.0f;
+    
+    // Spiral offsets are 10.6 and the rotation matrix 2.14, so projected
+    // points come out in 12.20
+    const int OFFSET_SHIFT = 6;
+    const int MATRIX_SHIFT = 14;
+    const int POINT_SHIFT = OFFSET_SHIFT + MATRIX_SHIFT;
+    
+    const uint8_t ALPHA = 0.6f * 255;
+    
+    static ArenaState<State> state;
     
-    static State state;
+    // Spiral points built per prepare() call
+    static const uint16_t PREPARE_BATCH = 128;
+    
+    bool prepare(void* memory) {
+        if (!state.constructed()) {
+            state.construct(memory);
+            state->accumulation = Accumulation::allocate();
+        }
+        
+        // One arm at rest; the layers differ only by rotation and scale. The
+        // float loop is kept as it was so the point count doesn't change, and
+        // picks up at the angle the previous batch stopped at.
+        uint16_t count = state->spiralPoints;
+        uint16_t end = min(SPIRAL_CAPACITY, (uint16_t)(count + PREPARE_BATCH));
+        float angle = state->spiralAngle;
+        for (; angle < M_PI * 4 && count < end; angle += 0.03f) {
+            float radius = angle * 3 * SCALE * (1 << OFFSET_SHIFT);
+            state->spiral[count].x = (int16_t)lroundf(cosf(angle) * radius);
+            state->spiral[count].y = (int16_t)lroundf(sinf(angle) * radius);
+            count++;
+        }
+        state->spiralPoints = count;
+        state->spiralAngle = angle;
+        return angle >= M_PI * 4 || count == SPIRAL_CAPACITY;
+    }
+    
+    void init(void* memory) {
+        // Finish whatever of the spiral wasn't built ahead of time
+        while (!prepare(memory)) {
+        }
+    }
     
-    void init() {
-        state.frameCount = 0;
-        state.initialized = true;
+    // The thick line footprint: (x, y) and the pixels right of and below it,
+    // with one bounds check for the common case away from the edges. The
+    // pixel pointer is only formed once (x, y) is known to be on the panel.
+    static inline void stamp(uint32_t* accumulation, int x, int y, uint32_t color, uint16_t alpha) {
+        if ((unsigned)x < DISPLAY_WIDTH - 1 && (unsigned)y < DISPLAY_HEIGHT - 1) {
+            uint32_t* pixel = accumulation + y * DISPLAY_WIDTH + x;
+            pixel[0] = Accumulation::blend(pixel[0], color, alpha);
+            pixel[1] = Accumulation::blend(pixel[1], color, alpha);
+            pixel[DISPLAY_WIDTH] = Accumulation::blend(pixel[DISPLAY_WIDTH], color, alpha);
+            return;
+        }
+        
+        // Last row or column: only the pixels that are on the panel
+        if ((unsigned)x >= DISPLAY_WIDTH || (unsigned)y >= DISPLAY_HEIGHT) return;
+        uint32_t* pixel = accumulation + y * DISPLAY_WIDTH + x;
+        *pixel = Accumulation::blend(*pixel, color, alpha);
+        if (x + 1 < DISPLAY_WIDTH) {
+            pixel[1] = Accumulation::blend(pixel[1], color, alpha);
+        }
+        if (y + 1 < DISPLAY_HEIGHT) {
+            pixel[DISPLAY_WIDTH] = Accumulation::blend(pixel[DISPLAY_WIDTH], color, alpha);
+        }
     }
     
-    void render() {
-        if (!state.initialized) {
-            init();
+    static inline void stamp565(int x, int y, uint16_t color) {
+        if ((unsigned)x >= DISPLAY_WIDTH || (unsigned)y >= DISPLAY_HEIGHT) return;
+        
+        AnimationUtils::drawPixelWithBlend(x, y, color, ALPHA);
+        if (x + 1 < DISPLAY_WIDTH) {
+            AnimationUtils::drawPixelWithBlend(x + 1, y, color, ALPHA);
+        }
+        if (y + 1 < DISPLAY_HEIGHT) {
+            AnimationUtils::drawPixelWithBlend(x, y + 1, color, ALPHA);
         }
+    }
+    
+    void CLOCK_HOT_PATH render() {
+        state->frameCount++;
         
-        state.frameCount++;
+        const int32_t centerX = (int32_t)(DISPLAY_WIDTH / 2) << POINT_SHIFT;
+        const int32_t centerY = (int32_t)(DISPLAY_HEIGHT / 2) << POINT_SHIFT;
+        float time = state->frameCount * 0.01f;
         
-        float centerX = 64;
-        float centerY = 32;
-        float time = state.frameCount * 0.01f;
+        AnimationUtils::beginAccumulation(state->accumulation);
+        uint32_t* accumulation = state->accumulation;
         
         // Fade effect
         AnimationUtils::applyFade(255-35);
         
+        const SpiralPoint* spiral = state->spiral;
+        const uint16_t count = state->spiralPoints;
+        
         // Spiral arms with 4 layers and 2 arms each
         for (int layer = 0; layer < 4; layer++) {
+            // Each layer has one colour per frame
+            float hue = fmod(layer * 45 + time * 30, 360) / 360.0f;
+            uint16_t color = AnimationUtils::hslTo565((uint16_t)(uint32_t)(hue * 65536), 255, 153);
+            uint32_t packed = Accumulation::from565(color);
+            
+            float depth = 0.8f + layer * 0.2f;
+            float rotationSpeed = 0.8f + layer * 0.2f;
+            float rotation = time * rotationSpeed + layer * M_PI / 4;
+            
+            // Rotation by the layer's angle and scale by its depth; the
+            // second arm is the first turned half way round
+            int32_t cosine = lroundf(cosf(rotation) * depth * (1 << MATRIX_SHIFT));
+            int32_t sine = lroundf(sinf(rotation) * depth * (1 << MATRIX_SHIFT));
+            
             for (int arm = 0; arm < 2; arm++) {
-                float startAngle = (arm * M_PI) + (layer * M_PI / 4);
-                float rotationSpeed = 0.8f + layer * 0.2f;
-                
-                for (float angle = 0; angle < M_PI * 4; angle += 0.03f) {
-                    float depth = 0.8f + layer * 0.2f;
-                    float radius = angle * 3 * depth;
-                    float totalAngle = angle + time * rotationSpeed + startAngle;
-                    float x = centerX + cos(totalAngle) * radius;
-                    float y = centerY + sin(totalAngle) * radius;
+                for (uint16_t i = 0; i < count; i++) {
+                    int32_t dx = spiral[i].x * cosine - spiral[i].y * sine;
+                    int32_t dy = spiral[i].x * sine + spiral[i].y * cosine;
+                    int x = (centerX + dx) >> POINT_SHIFT;
+                    int y = (centerY + dy) >> POINT_SHIFT;
                     
-                    if (x >= 0 && x < DISPLAY_WIDTH && y >= 0 && y < DISPLAY_HEIGHT) {
-                        float hue = fmod(layer * 45 + time * 30, 360) / 360.0f;
-                        uint8_t r, g, b;
-                        AnimationUtils::hslToRgb(hue, 1.0f, 0.6f, &r, &g, &b);
-                        
-                        uint8_t alpha = 0.6f * 255;
-                        AnimationUtils::drawPixelWithBlend(x, y, AnimationUtils::rgb888To565(r, g, b), alpha);
-                        
-                        // Make lines thicker
-                        if (x + 1 < DISPLAY_WIDTH) {
-                            AnimationUtils::drawPixelWithBlend(x + 1, y, AnimationUtils::rgb888To565(r, g, b), alpha);
-                        }
-                        if (y + 1 < DISPLAY_HEIGHT) {
-                            AnimationUtils::drawPixelWithBlend(x, y + 1, AnimationUtils::rgb888To565(r, g, b), alpha);
-                        }
+                    if (accumulation) {
+                        stamp(accumulation, x, y, packed, ALPHA + (ALPHA >> 7));
+                    } else {
+                        stamp565(x, y, color);
                     }
                 }
+                cosine = -cosine;
+                sine = -sine;
             }
         }
+        
+        AnimationUtils::resolveAccumulation();
     }
     
-    const char* getName() {
-        return "Galaxy";
+    void teardown() {
+        if (state.constructed()) {
+            Accumulation::release(state->accumulation);
+        }
+        state.destroy();
     }
-}
\ No newline at end of file
+    
+    constexpr AnimationDescriptor descriptor = {
+        "Galaxy",
+        prepare,
+        init,
+        renderNext<render>,
+        teardown,
+        false,
+        false,
+        AA_BOX_3X3,
+        60,
+        sizeof(State)
+    };
+}
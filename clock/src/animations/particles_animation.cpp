@@ -1,57 +1,83 @@
 #include "animations_modules.h"
 #include "animation_utils.h"
 #include "display.h"
+#include "particles.h"
 #include <cmath>
 
 namespace ParticlesAnimation {
-    // Private state - completely contained within this namespace
+    const uint16_t MAX_PARTICLES = 1024;
+    const uint8_t EMITTERS = 5;
+    
     struct State {
         uint32_t frameCount = 0;
-        bool initialized = false;
+        uint32_t* accumulation = nullptr; // Trails, when there is room for them
+        Particles::Pool pool;
+        Particles::Emitter emitters[EMITTERS];
     };
+    static_assert(sizeof(State) <= STATE_BUDGET, "State has outgrown its budget in ANIMATION_LIST");
     
-    static State state;
+    static ArenaState<State> state;
     
-    void init() {
-        state.frameCount = 0;
-        state.initialized = true;
+    void init(void* memory) {
+        state.construct(memory);
+        state->accumulation = Accumulation::allocate();
+        Particles::allocate(state->pool, MAX_PARTICLES);
+        
+        // Streams from the left edge, each a little faster than the last
+        for (int i = 0; i < EMITTERS; i++) {
+            Particles::Emitter& emitter = state->emitters[i];
+            emitter.x = Particles::toFixed(-2);
+            emitter.vx = Particles::toFixed(0.6f + i * 0.15f);
+            emitter.spread = Particles::toFixed(0.1f);
+            emitter.rate = 128;  // One particle every other frame
+            emitter.life = 255;
+        }
     }
     
-    void render() {
-        if (!state.initialized) {
-            init();
-        }
-        
+    void CLOCK_HOT_PATH render() {
         // Reset frame count before it gets too large to prevent overflow
-        state.frameCount = (state.frameCount + 1) % 1000000;
+        state->frameCount = (state->frameCount + 1) % 1000000;
+        
+        AnimationUtils::beginAccumulation(state->accumulation);
         
         // Fade effect
         AnimationUtils::applyFade(255-23);
         
-        // Draw 15 particles matching original implementation
-        for (int i = 0; i < 15; i++) {
-            // Calculate position
-            float x = fmod(state.frameCount * 0.3f * (1 + i * 0.1f) + i * 25, 140) - 6;
-            float y = 32 + sin(state.frameCount * 0.02f + i) * 25;
+        // Emitters bob up and down the left edge, cycling through the hues
+        for (int i = 0; i < EMITTERS; i++) {
+            Particles::Emitter& emitter = state->emitters[i];
+            emitter.y = Particles::toFixed(DISPLAY_HEIGHT / 2 + sin(state->frameCount * 0.02f + i) * (DISPLAY_HEIGHT * 25 / 64));
             
-            // Only draw if within bounds
-            if (x >= 0 && x < DISPLAY_WIDTH && y >= 0 && y < DISPLAY_HEIGHT) {
-                // Calculate hue
-                float hue = fmod(state.frameCount * 0.8f + i * 40, 360) / 360.0f;
-                uint8_t r, g, b;
-                AnimationUtils::hslToRgb(hue, 0.9f, 0.6f, &r, &g, &b);
-                AnimationUtils::fillCircle(x, y, 2, display.color565(r,g,b));
-                
-                float trailX = x - 8;
-                if (trailX >= 0 && trailX < DISPLAY_WIDTH) {
-                    uint16_t color = AnimationUtils::alphaBlend(trailX, y, r, g, b, 77);
-                    AnimationUtils::fillCircle(trailX, y, 1.2, color);
-                }
-            }
+            float hue = fmod(state->frameCount * 0.8f + i * 72, 360) / 360.0f;
+            emitter.color = AnimationUtils::hslTo565((uint16_t)(uint32_t)(hue * 65536), 230, 153);
+            
+            Particles::emit(state->pool, emitter);
         }
+        
+        Particles::update(state->pool);
+        Particles::draw(state->pool, state->accumulation);
+        
+        AnimationUtils::resolveAccumulation();
     }
     
-    const char* getName() {
-        return "Particles";
+    void teardown() {
+        if (state.constructed()) {
+            Accumulation::release(state->accumulation);
+            Particles::release(state->pool);
+        }
+        state.destroy();
     }
-}
\ No newline at end of file
+    
+    constexpr AnimationDescriptor descriptor = {
+        "Particles",
+        nullptr,
+        init,
+        renderNext<render>,
+        teardown,
+        false,
+        false,
+        AA_BOX_3X3,
+        60,
+        sizeof(State)
+    };
+}
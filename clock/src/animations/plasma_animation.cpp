@@ -4,62 +4,119 @@
 #include <FastLED.h>
 
 namespace PlasmaAnimation {
-    // Private state - completely contained within this namespace
     struct State {
-        float plasmaTime = 0.0f;
-        bool initialized = false;
+        uint16_t palette[256];   // Colour for each plasma level
+        uint16_t preparedEntries = 0;
+        
+        // Per-frame tables of the x, y and x+y sine terms
+        uint16_t xTerm[DISPLAY_WIDTH];
+        uint16_t yTerm[DISPLAY_HEIGHT];
+        uint16_t diagonalTerm[DISPLAY_WIDTH + DISPLAY_HEIGHT - 1];
     };
+    static_assert(sizeof(State) <= STATE_BUDGET, "State has outgrown its budget in ANIMATION_LIST");
+    
+    static ArenaState<State> state;
+    
+    // Palette entries built per prepare() call
+    static const uint16_t PREPARE_BATCH = 32;
     
-    static State state;
+    // Colour of plasma level `index` (0-255 covering -1.0 to 1.0)
+    static HSL levelColor(uint8_t index) {
+        float plasma = index / 127.5f - 1.0f;
+        
+        float hue = 280 + plasma * 80;
+        float saturation = 0.7f + plasma * 0.3f;
+        float lightness = 0.4f + plasma * 0.3f;
+        
+        // Ensure hue stays within 0-360 range
+        while (hue < 0) hue += 360.0f;
+        while (hue >= 360.0f) hue -= 360.0f;
+        
+        HSL color = {
+            (uint16_t)(uint32_t)(hue * (65536 / 360.0f)),
+            (uint8_t)(saturation * 255 + 0.5f),
+            (uint8_t)(lightness * 255 + 0.5f)
+        };
+        return color;
+    }
     
-    void init() {
-        state.plasmaTime = 0;
-        state.initialized = true;
+    // One sine term of the plasma for a sin16 angle, as (sin + 1) * 85 in
+    // 8.8 fixed point; three of these add up to (plasma + 1) * 127.5
+    static inline uint16_t term(float angle) {
+        // sin16 takes values 0-65535 representing 0-2π and returns -32767 to 32767
+        int16_t sine = sin16((uint16_t)(int32_t)angle);
+        return ((uint32_t)(sine + 32767) * (85 * 256)) / 65534;
     }
     
-    void render() {
-        if (!state.initialized) {
-            init();
+    bool prepare(void* memory) {
+        if (!state.constructed()) {
+            state.construct(memory);
         }
         
-        state.plasmaTime += 0.1f;
+        // Bake the palette a batch at a time
+        uint16_t start = state->preparedEntries;
+        uint16_t end = min(256, start + PREPARE_BATCH);
+        HSL colors[PREPARE_BATCH];
+        for (int i = start; i < end; i++) {
+            colors[i - start] = levelColor(i);
+        }
+        AnimationUtils::hslTo565Batch(colors, &state->palette[start], end - start);
+        state->preparedEntries = end;
+        return state->preparedEntries == 256;
+    }
+    
+    void init(void* memory) {
+        // Finish any palette baking that wasn't done ahead of time
+        while (!prepare(memory)) {
+        }
+    }
+    
+    void CLOCK_HOT_PATH renderAt(uint32_t frame) {
+        // plasmaTime advances 0.1 per frame and wraps at 628 (2*PI*100), so
+        // the pattern repeats every 6280 frames. Reducing the frame index first
+        // keeps the float product exact for arbitrarily large frame numbers.
+        float plasmaTime = (frame % 6280) * 0.1f;
+        uint8_t* indices = display.getIndexedTarget();
         
-        // Keep plasmaTime within a reasonable range to prevent precision loss
-        // and ensure FastLED's sin16 lookup tables work optimally
-        if (state.plasmaTime > 628.0f) {  // 2*PI*100 ≈ 628
-            state.plasmaTime -= 628.0f;
+        // The three sine terms depend on x, y and x+y alone, so each is a
+        // 1-D table per frame. Entries hold (sin + 1) scaled so that the three
+        // of them sum straight to a palette index in 8.8 fixed point.
+        for (int x = 0; x < DISPLAY_WIDTH; x++) {
+            state->xTerm[x] = term((x * 0.08f + plasmaTime) * 10430.0f);  // 65535/(2*PI)
+        }
+        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+            state->yTerm[y] = term((y * 0.08f + plasmaTime * 1.2f) * 10430.0f);
+        }
+        for (int d = 0; d < DISPLAY_WIDTH + DISPLAY_HEIGHT - 1; d++) {
+            state->diagonalTerm[d] = term((d * 0.04f + plasmaTime * 0.8f) * 10430.0f);
         }
         
         for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+            uint8_t* row = indices + y * DISPLAY_WIDTH;
+            const uint16_t* diagonal = state->diagonalTerm + y;
+            uint16_t yTerm = state->yTerm[y];
             for (int x = 0; x < DISPLAY_WIDTH; x++) {
-                // Use FastLED's sin16 for better performance and precision
-                // sin16 takes values 0-65535 representing 0-2π
-                uint16_t angle1 = (uint16_t)((x * 0.08f + state.plasmaTime) * 10430.0f);  // 65535/(2*PI)
-                uint16_t angle2 = (uint16_t)((y * 0.08f + state.plasmaTime * 1.2f) * 10430.0f);
-                uint16_t angle3 = (uint16_t)(((x + y) * 0.04f + state.plasmaTime * 0.8f) * 10430.0f);
-                
-                // sin16 returns -32767 to 32767, convert to -1.0 to 1.0
-                float v1 = sin16(angle1) / 32767.0f;
-                float v2 = sin16(angle2) / 32767.0f;
-                float v3 = sin16(angle3) / 32767.0f;
-                float plasma = (v1 + v2 + v3) / 3.0f;
-                
-                float hue = 280 + plasma * 80;
-                float saturation = 0.7f + plasma * 0.3f;
-                float lightness = 0.4f + plasma * 0.3f;
-                
-                // Ensure hue stays within 0-360 range
-                while (hue < 0) hue += 360.0f;
-                while (hue >= 360.0f) hue -= 360.0f;
-                
-                uint8_t r, g, b;
-                AnimationUtils::hslToRgb(hue / 360.0f, saturation, lightness, &r, &g, &b);
-                display.drawPixelRGB888(x, y, r, g, b);
+                row[x] = (state->xTerm[x] + yTerm + diagonal[x]) >> 8;
             }
         }
+        
+        display.resolveIndexed(state->palette);
     }
     
-    const char* getName() {
-        return "Plasma";
+    void teardown() {
+        state.destroy();
     }
+    
+    constexpr AnimationDescriptor descriptor = {
+        "Plasma",
+        prepare,
+        init,
+        renderAt,
+        teardown,
+        true,
+        true,
+        AA_BOX_3X3,
+        60,
+        sizeof(State)
+    };
 }
\ No newline at end of file
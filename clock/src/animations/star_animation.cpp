@@ -5,123 +5,156 @@
 #include <cmath>
 
 namespace StarAnimation {
-    // Private state - completely contained within this namespace
+    // Stars come in SPRITE_SIZES sizes, 1 to 3 pixels in half pixel steps.
+    // Each has one sprite holding its glow and core, up to SPRITE_DIM square.
+    const uint8_t SPRITE_SIZES = 5;
+    const uint8_t SPRITE_DIM = 13;
+    
+    static_assert(DISPLAY_WIDTH <= 256 && DISPLAY_HEIGHT <= 256, "Star positions are 8-bit");
+    
     struct Star {
-        float x, y;
-        float size;
-        float phase;
-        float twinkleSpeed;
-        bool active;
+        uint8_t x, y;
+        uint8_t sprite;          // Size index
+        uint16_t phase;          // Twinkle phase, sin16 angle
+        uint16_t twinkleSpeed;   // Added to phase each frame
     };
     
     struct State {
-        Star stars[50];  // 50 stars
-        uint32_t frameCount = 0;
-        bool initialized = false;
+        Star stars[MAX_STARS];
+        uint16_t preparedStars = 0;
+        uint8_t bakedSprites = 0;
+        uint8_t sprites[SPRITE_SIZES][SPRITE_DIM * SPRITE_DIM];
+        uint8_t spriteExtent[SPRITE_SIZES];   // Pixels from the centre to the sprite's edge
     };
+    static_assert(sizeof(State) <= STATE_BUDGET, "State has outgrown its budget in ANIMATION_LIST");
+    
+    static ArenaState<State> state;
+    static uint16_t starCount = 50;
     
-    static State state;
+    // Stars generated per prepare() call
+    static const uint8_t PREPARE_BATCH = 50;
     
-    void init() {
-        // Initialize stars
-        for (int i = 0; i < 50; i++) {
-            state.stars[i].x = random(0, DISPLAY_WIDTH);
-            state.stars[i].y = random(0, DISPLAY_HEIGHT);
-            state.stars[i].size = 1.0f + (random(0, 100) / 100.0f) * 2.0f; // Size 1-3
-            state.stars[i].phase = random(0, 628) / 100.0f; // Random phase 0-2π
-            state.stars[i].twinkleSpeed = 0.05f + (random(0, 100) / 100.0f) * 0.1f; // Speed 0.05-0.15
-            state.stars[i].active = true;
+    // Stars dimmer than this (0.15 of full) aren't drawn
+    static const uint8_t MIN_LEVEL = 38;
+    
+    void setStarCount(uint16_t count) {
+        starCount = count < 1 ? 1 : (count > MAX_STARS ? MAX_STARS : count);
+    }
+    
+    uint16_t getStarCount() {
+        return starCount;
+    }
+    
+    // Glow and core of a star of `size` pixels, centred on SPRITE_DIM / 2.
+    // Sampled on a half pixel grid: the glow fades out to twice the size and
+    // adds up where samples share a pixel, the core is solid to 0.8 * size.
+    static uint8_t bakeSprite(uint8_t* sprite, float size) {
+        const int center = SPRITE_DIM / 2;
+        uint16_t glow[SPRITE_DIM * SPRITE_DIM] = {};
+        bool core[SPRITE_DIM * SPRITE_DIM] = {};
+        
+        float glowRadius = size * 2.0f;
+        for (float dy = -glowRadius; dy <= glowRadius; dy += 0.5f) {
+            for (float dx = -glowRadius; dx <= glowRadius; dx += 0.5f) {
+                float intensity = (1.0f - sqrtf(dx * dx + dy * dy) / glowRadius) * 0.4f;
+                if (intensity > 0.1f) {
+                    glow[(center + (int)floorf(dy)) * SPRITE_DIM + center + (int)floorf(dx)] += intensity * 200;
+                }
+            }
         }
         
-        state.frameCount = 0;
-        state.initialized = true;
+        float coreRadius = size * 0.8f;
+        for (float dy = -coreRadius; dy <= coreRadius; dy += 0.5f) {
+            for (float dx = -coreRadius; dx <= coreRadius; dx += 0.5f) {
+                if (dx * dx + dy * dy <= coreRadius * coreRadius) {
+                    core[(center + (int)floorf(dy)) * SPRITE_DIM + center + (int)floorf(dx)] = true;
+                }
+            }
+        }
+        
+        uint8_t extent = 0;
+        for (int i = 0; i < SPRITE_DIM * SPRITE_DIM; i++) {
+            sprite[i] = core[i] ? 255 : min(255, (int)glow[i]);
+            if (sprite[i]) {
+                int dx = abs(i % SPRITE_DIM - center);
+                int dy = abs(i / SPRITE_DIM - center);
+                extent = max(extent, (uint8_t)max(dx, dy));
+            }
+        }
+        return extent;
     }
     
-    void render() {
-        if (!state.initialized) {
-            init();
+    bool prepare(void* memory) {
+        if (!state.constructed()) {
+            state.construct(memory);
         }
         
-        state.frameCount++;
+        // Sprites first, one per call; they are most of the work
+        if (state->bakedSprites < SPRITE_SIZES) {
+            uint8_t i = state->bakedSprites++;
+            state->spriteExtent[i] = bakeSprite(state->sprites[i], 1.0f + i * 0.5f);
+            return false;
+        }
         
-        // Dark blue background
-        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
-            for (int x = 0; x < DISPLAY_WIDTH; x++) {
-                display.drawPixel(x, y, AnimationUtils::rgb888To565(0, 0, 20)); // #000033
-            }
+        // Generate the star field a batch at a time
+        uint16_t end = min(MAX_STARS, (uint16_t)(state->preparedStars + PREPARE_BATCH));
+        for (int i = state->preparedStars; i < end; i++) {
+            state->stars[i].x = random(0, DISPLAY_WIDTH);
+            state->stars[i].y = random(0, DISPLAY_HEIGHT);
+            state->stars[i].sprite = random(0, SPRITE_SIZES);
+            state->stars[i].phase = random(0, 65536); // Random phase 0-2π
+            state->stars[i].twinkleSpeed = random(521, 1565); // 0.05-0.15 radians
+        }
+        state->preparedStars = end;
+        return state->preparedStars == MAX_STARS;
+    }
+    
+    void init(void* memory) {
+        // Finish any star field generation that wasn't done ahead of time
+        while (!prepare(memory)) {
         }
+    }
+    
+    void CLOCK_HOT_PATH render() {
+        // Dark blue background
+        AnimationUtils::fillRows(0, DISPLAY_HEIGHT, AnimationUtils::rgb888To565(0, 0, 20)); // #000014
         
         // Draw and update stars
-        for (int i = 0; i < 50; i++) {
-            Star& star = state.stars[i];
-            if (!star.active) continue;
+        for (int i = 0; i < starCount; i++) {
+            Star& star = state->stars[i];
             
-            // Update twinkle phase
+            // Update twinkle phase, and brightness 0-255 from it
             star.phase += star.twinkleSpeed;
-            if (star.phase > 2 * M_PI) {
-                star.phase -= 2 * M_PI;
-            }
-            
-            // Calculate brightness (0-1)
-            float brightness = (sin(star.phase) + 1.0f) / 2.0f;
+            uint8_t level = (sin16(star.phase) + 32767) >> 8;
             
             // Skip drawing if star is too dim to avoid black artifacts
-            if (brightness < 0.15f) {
+            if (level < MIN_LEVEL) {
                 continue;
             }
             
-            // Draw star glow (larger, dimmer circle)
-            float glowRadius = star.size * 2.0f;
-            for (float dy = -glowRadius; dy <= glowRadius; dy += 0.5f) {
-                for (float dx = -glowRadius; dx <= glowRadius; dx += 0.5f) {
-                    float distance = sqrt(dx * dx + dy * dy);
-                    if (distance <= glowRadius) {
-                        int px = (int)(star.x + dx);
-                        int py = (int)(star.y + dy);
-                        
-                        if (px >= 0 && px < DISPLAY_WIDTH && py >= 0 && py < DISPLAY_HEIGHT) {
-                            float glowIntensity = (1.0f - (distance / glowRadius)) * brightness * 0.4f;
-                            if (glowIntensity > 0.1f) { // Only draw if intensity is significant
-                                // Get background color and blend with it
-                                uint16_t bgColor = display.getPixel(px, py);
-                                uint8_t bgR, bgG, bgB;
-                                AnimationUtils::rgb565To888(bgColor, &bgR, &bgG, &bgB);
-                                
-                                // Add glow to background
-                                uint8_t glowAmount = (uint8_t)(glowIntensity * 200);
-                                uint8_t newR = min(255, bgR + glowAmount);
-                                uint8_t newG = min(255, bgG + glowAmount);
-                                uint8_t newB = min(255, bgB + glowAmount);
-                                
-                                uint16_t glowColor = AnimationUtils::rgb888To565(newR, newG, newB);
-                                display.drawPixel(px, py, glowColor);
-                            }
-                        }
-                    }
-                }
-            }
-            
-            // Draw star core (bright center)
-            float coreRadius = star.size * 0.8f;
-            for (float dy = -coreRadius; dy <= coreRadius; dy += 0.5f) {
-                for (float dx = -coreRadius; dx <= coreRadius; dx += 0.5f) {
-                    float distance = sqrt(dx * dx + dy * dy);
-                    if (distance <= coreRadius) {
-                        int px = (int)(star.x + dx);
-                        int py = (int)(star.y + dy);
-                        
-                        if (px >= 0 && px < DISPLAY_WIDTH && py >= 0 && py < DISPLAY_HEIGHT) {
-                            uint8_t coreBrightness = (uint8_t)(brightness * 255);
-                            uint16_t coreColor = AnimationUtils::rgb888To565(coreBrightness, coreBrightness, coreBrightness);
-                            display.drawPixel(px, py, coreColor);
-                        }
-                    }
-                }
-            }
+            // The sprite covers the star's pixel +- its extent
+            uint8_t extent = state->spriteExtent[star.sprite];
+            const uint8_t* sprite = state->sprites[star.sprite] +
+                (SPRITE_DIM / 2 - extent) * (SPRITE_DIM + 1);
+            AnimationUtils::addSprite(star.x - extent, star.y - extent, sprite,
+                                      extent * 2 + 1, extent * 2 + 1, SPRITE_DIM, level + 1);
         }
     }
     
-    const char* getName() {
-        return "Stars";
+    void teardown() {
+        state.destroy();
     }
-}
\ No newline at end of file
+    
+    constexpr AnimationDescriptor descriptor = {
+        "Stars",
+        prepare,
+        init,
+        renderNext<render>,
+        teardown,
+        false,
+        false,
+        AA_BOX_3X3,
+        60,
+        sizeof(State)
+    };
+}
@@ -8,43 +8,260 @@ static AnimationType currentAnimation = ANIM_PLASMA;
 static AnimationType targetAnimation = ANIM_PLASMA;
 static unsigned long lastCycleTime = 0;
 static unsigned long animationDuration = 3 * 60 * 60 * 1000; // 3 hours per animation
+static unsigned long animationStartTime = 0;
 
-// Fade state
-static bool fadeActive = false;
-static bool fadeOut = false;
-static unsigned long fadeStartTime = 0;
-static const unsigned long FADE_DURATION = 3000; // 3 second
+// Warm-up state for the animation that will be switched in next
+static AnimationType preparedAnimation = ANIM_COUNT;
+static bool preparedReady = false;
 
-void initAnimations() {
-    // Initialize the current animation
-    switch(currentAnimation) {
-        case ANIM_PLASMA:
-            PlasmaAnimation::init();
-            break;
-        case ANIM_PARTICLES:
-            ParticlesAnimation::init();
-            break;
-        case ANIM_FIRE:
-            FireAnimation::init();
-            break;
-        case ANIM_GALAXY:
-            GalaxyAnimation::init();
-            break;
-        case ANIM_STARS:
-            StarAnimation::init();
-            break;
-        case ANIM_BEACH:
-            BeachAnimation::init();
-            break;
-        case ANIM_DVD_LOGO:
-            DVDLogoAnimation::init();
-            break;
-        default:
-            PlasmaAnimation::init();
-            break;
+// Worst frame times seen, in microseconds
+static unsigned long worstFrameTime = 0;
+static unsigned long worstTransitionFrameTime = 0;
+
+// Transition state. A requested switch waits (briefly) for the target to be
+// warmed up, then both animations run side by side while they are blended.
+// Each draws into its own buffer and the blend goes to the frame buffer, so
+// animations that build on their previous frame never see the other one.
+static bool switchPending = false;
+static unsigned long switchRequestTime = 0;
+static bool transitionActive = false;
+static AnimationType incomingAnimation = ANIM_PLASMA;
+static TransitionType transitionType = TRANSITION_CROSSFADE;
+static unsigned long transitionStartTime = 0;
+static uint16_t* outgoingBuffer = nullptr;
+static uint16_t* incomingBuffer = nullptr;
+static bool fadeHalfway = false; // Palette fade has moved on to the incoming animation
+static const unsigned long TRANSITION_DURATION = 2000; // 2 seconds
+static const unsigned long PREPARE_TIMEOUT = 500; // Longest a switch waits for warm-up
+static const unsigned long WARMUP_LEAD = 10000; // How long before an automatic switch warm-up starts
+
+// The registry, indexed by AnimationType
+#define REGISTER_ANIMATION(id, ns, stateBudget) &ns::descriptor,
+static constexpr const AnimationDescriptor* ANIMATIONS[ANIM_COUNT] = {
+    ANIMATION_LIST(REGISTER_ANIMATION)
+};
+#undef REGISTER_ANIMATION
+
+#define STATE_BUDGET(id, ns, stateBudget) stateBudget,
+static constexpr size_t STATE_BUDGETS[ANIM_COUNT] = {
+    ANIMATION_LIST(STATE_BUDGET)
+};
+#undef STATE_BUDGET
+
+static constexpr size_t largestStateBudget(int i = 0) {
+    return i == ANIM_COUNT ? 0 :
+        (STATE_BUDGETS[i] > largestStateBudget(i + 1) ? STATE_BUDGETS[i] : largestStateBudget(i + 1));
+}
+
+static constexpr size_t totalStateBudget(int i = 0) {
+    return i == ANIM_COUNT ? 0 : STATE_BUDGETS[i] + totalStateBudget(i + 1);
+}
+
+// Shared state arena. The active slot holds the state of the animation on
+// screen and is kept for good. The spare slot holds the incoming animation
+// during a transition, or the one being warmed up before it; it is only
+// allocated for the switch and freed once the outgoing State is torn down.
+// Slots are malloc'd, which aligns them for any State.
+static constexpr size_t STATE_SLOT_SIZE = largestStateBudget();
+static_assert(STATE_SLOT_SIZE < totalStateBudget(),
+              "Between switches the arena should take less than every State kept as a static");
+
+static uint8_t* stateArena[2] = {nullptr, nullptr};
+static uint8_t activeSlot = 0;
+
+// The spare slot, allocated on first use; nullptr if there is no room for it
+static void* spareSlot() {
+    uint8_t*& spare = stateArena[activeSlot ^ 1];
+    if (!spare) {
+        spare = (uint8_t*)malloc(STATE_SLOT_SIZE);
     }
+    return spare;
+}
+
+// Once the outgoing State is torn down its slot becomes the spare, which
+// isn't needed until the next switch
+static void retireOutgoingSlot() {
+    activeSlot ^= 1;
+    free(stateArena[activeSlot ^ 1]);
+    stateArena[activeSlot ^ 1] = nullptr;
+}
+
+static void allocateStateArena() {
+    stateArena[activeSlot] = (uint8_t*)malloc(STATE_SLOT_SIZE);
+    if (!stateArena[activeSlot]) {
+        Serial.println("Not enough memory for the animation state arena");
+        ESP.restart();
+    }
+}
+
+// Time between frames of an animation, in milliseconds
+static unsigned long frameIntervalOf(AnimationType type) {
+    return 1000 / ANIMATIONS[type]->targetFps;
+}
+
+// Frame index of an animation started at `startTime`
+static uint32_t frameSince(AnimationType type, unsigned long startTime) {
+    return (millis() - startTime) / frameIntervalOf(type) + 1;
+}
+
+// Drop whatever was warmed up in the spare slot
+static void abandonPrepared() {
+    if (preparedAnimation != ANIM_COUNT) {
+        ANIMATIONS[preparedAnimation]->teardown();
+    }
+    preparedAnimation = ANIM_COUNT;
+    preparedReady = false;
+}
+
+static void initAnimation(AnimationType type, void* memory) {
+    // A warmed-up animation picks up its state where prepare() left it
+    if (type != preparedAnimation) {
+        abandonPrepared();
+    }
+    ANIMATIONS[type]->init(memory);
+    
+    // Whatever was warmed up has now been consumed
+    preparedAnimation = ANIM_COUNT;
+    preparedReady = false;
+}
+
+void initAnimations() {
+    allocateStateArena();
+    initAnimation(currentAnimation, stateArena[activeSlot]);
+    display.setAntialiasMode(ANIMATIONS[currentAnimation]->antialias);
     
     lastCycleTime = millis();
+    animationStartTime = lastCycleTime;
+}
+
+static bool prepareAnimation(AnimationType type) {
+    // Animations without a prepare hook have nothing to set up ahead of time
+    bool (*prepare)(void*) = ANIMATIONS[type]->prepare;
+    if (!prepare) return true;
+    
+    void* memory = spareSlot();
+    return memory && prepare(memory);
+}
+
+void prepareNextAnimation() {
+    // The spare slot is taken by the incoming animation until it finishes
+    if (transitionActive) return;
+    
+    // A pending switch takes priority, otherwise warm up the next one in the
+    // cycle, but only once it is nearly due so the spare slot isn't held
+    if (!switchPending && millis() - lastCycleTime + WARMUP_LEAD < animationDuration) return;
+    AnimationType next = switchPending ?
+        targetAnimation : (AnimationType)((currentAnimation + 1) % ANIM_COUNT);
+    if (next == currentAnimation) return;
+    
+    if (next != preparedAnimation) {
+        abandonPrepared();
+        preparedAnimation = next;
+    }
+    
+    if (!preparedReady) {
+        preparedReady = prepareAnimation(next);
+    }
+}
+
+// Puts the incoming animation on screen without a transition, on a blank frame
+static void cutOver() {
+    currentAnimation = incomingAnimation;
+    animationStartTime = millis();
+    display.setAntialiasMode(ANIMATIONS[currentAnimation]->antialias);
+    display.clearData();
+}
+
+static void startTransition() {
+    switchPending = false;
+    incomingAnimation = targetAnimation;
+    
+    // Without room for a second State the incoming animation replaces the
+    // outgoing one in its slot
+    void* memory = spareSlot();
+    if (!memory) {
+        ANIMATIONS[currentAnimation]->teardown();
+        initAnimation(incomingAnimation, stateArena[activeSlot]);
+        cutOver();
+        return;
+    }
+    initAnimation(incomingAnimation, memory);
+    
+    outgoingBuffer = (uint16_t*)malloc(BufferMatrixPanel::FRAME_BYTES);
+    incomingBuffer = (uint16_t*)calloc(1, BufferMatrixPanel::FRAME_BYTES);
+    if (!outgoingBuffer || !incomingBuffer) {
+        free(outgoingBuffer);
+        free(incomingBuffer);
+        outgoingBuffer = incomingBuffer = nullptr;
+        
+        // No room to render both animations. If either is indexed, fade
+        // through black by palette instead (see renderPaletteFade), otherwise
+        // cut straight over.
+        if (ANIMATIONS[currentAnimation]->indexed || ANIMATIONS[incomingAnimation]->indexed) {
+            fadeHalfway = false;
+            transitionActive = true;
+            transitionStartTime = millis();
+            return;
+        }
+        ANIMATIONS[currentAnimation]->teardown();
+        retireOutgoingSlot();
+        cutOver();
+        return;
+    }
+    
+    // The outgoing animation carries on from what it last drew
+    memcpy(outgoingBuffer, display.getFrameBuffer(), BufferMatrixPanel::FRAME_BYTES);
+    
+    transitionActive = true;
+    transitionStartTime = millis();
+}
+
+static void finishTransition() {
+    // The incoming animation carries on from its own buffer, which matters
+    // for animations that build on the previous frame
+    if (incomingBuffer) {
+        memcpy(display.getFrameBuffer(), incomingBuffer, BufferMatrixPanel::FRAME_BYTES);
+    }
+    free(outgoingBuffer);
+    free(incomingBuffer);
+    outgoingBuffer = incomingBuffer = nullptr;
+    
+    // The outgoing state is no longer needed, nor is its slot
+    ANIMATIONS[currentAnimation]->teardown();
+    retireOutgoingSlot();
+    currentAnimation = incomingAnimation;
+    animationStartTime = transitionStartTime;
+    display.setAntialiasMode(ANIMATIONS[currentAnimation]->antialias);
+    transitionActive = false;
+}
+
+// Transition without the off-screen buffers: the outgoing animation fades
+// out over the first half and the incoming one fades in over the second,
+// both by palette level, so only indexed animations actually fade
+static void renderPaletteFade() {
+    unsigned long elapsed = millis() - transitionStartTime;
+    if (elapsed >= TRANSITION_DURATION) {
+        display.setPaletteLevel(255);
+        finishTransition();
+        ANIMATIONS[currentAnimation]->render(frameSince(currentAnimation, animationStartTime));
+        return;
+    }
+    
+    unsigned long half = TRANSITION_DURATION / 2;
+    if (elapsed < half) {
+        display.setPaletteLevel(255 * (half - elapsed) / half);
+        ANIMATIONS[currentAnimation]->render(frameSince(currentAnimation, animationStartTime));
+        return;
+    }
+    
+    // The incoming animation starts on a blank frame
+    if (!fadeHalfway) {
+        fadeHalfway = true;
+        display.setAntialiasMode(ANIMATIONS[incomingAnimation]->antialias);
+        display.clearData();
+    }
+    display.setPaletteLevel(255 * (elapsed - half) / half);
+    ANIMATIONS[incomingAnimation]->render(frameSince(incomingAnimation, transitionStartTime));
 }
 
 void renderCurrentAnimation() {
@@ -53,78 +270,67 @@ void renderCurrentAnimation() {
         cycleToNextAnimation();
     }
     
-    // Render the current animation
-    switch(currentAnimation) {
-        case ANIM_PLASMA:
-            PlasmaAnimation::render();
-            break;
-        case ANIM_PARTICLES:
-            ParticlesAnimation::render();
-            break;
-        case ANIM_FIRE:
-            FireAnimation::render();
-            break;
-        case ANIM_GALAXY:
-            GalaxyAnimation::render();
-            break;
-        case ANIM_STARS:
-            StarAnimation::render();
-            break;
-        case ANIM_BEACH:
-            BeachAnimation::render();
-            break;
-        case ANIM_DVD_LOGO:
-            DVDLogoAnimation::render();
-            break;
-        default:
-            PlasmaAnimation::render();
-            break;
-    }
-    
-    // Apply fade if active
-    if (fadeActive) {
-        unsigned long elapsed = millis() - fadeStartTime;
-
-        uint8_t fadeLevel;
-        float progress = (float)elapsed / FADE_DURATION;
-        if (fadeOut) {
-            fadeLevel = 255 - (uint8_t)(progress * 255);
-            if (elapsed > FADE_DURATION) {
-                currentAnimation = targetAnimation;
-                initAnimations();
-
-                // Screen should be blank by now but just in case.
-                display.clearData();
-
-                startFadeIn();
-            }
-        } else {
-            fadeLevel = (uint8_t)(progress * 255);
-            if (elapsed > FADE_DURATION) {
-                fadeActive = false;
-                fadeLevel = 255;
-            }
+    // Start a requested switch once its target is warmed up
+    if (switchPending && !transitionActive) {
+        bool ready = preparedAnimation == targetAnimation && preparedReady;
+        if (ready || millis() - switchRequestTime > PREPARE_TIMEOUT) {
+            startTransition();
         }
+    }
+    
+    // Seekable animations are driven by the clock rather than by the number
+    // of frames actually drawn, so they skip ahead instead of slowing down
+    // when a frame takes longer than the frame interval.
+    if (!transitionActive) {
+        ANIMATIONS[currentAnimation]->render(frameSince(currentAnimation, animationStartTime));
+        return;
+    }
+    
+    if (!incomingBuffer) {
+        renderPaletteFade();
+        return;
+    }
+    
+    // Both animations render off screen, then one blend pass composes the frame
+    display.setRenderTarget(outgoingBuffer);
+    ANIMATIONS[currentAnimation]->render(frameSince(currentAnimation, animationStartTime));
+    display.setRenderTarget(incomingBuffer);
+    ANIMATIONS[incomingAnimation]->render(frameSince(incomingAnimation, transitionStartTime));
+    display.setRenderTarget(nullptr);
+    
+    unsigned long elapsed = millis() - transitionStartTime;
+    if (elapsed >= TRANSITION_DURATION) {
+        finishTransition();
+    } else {
+        uint16_t progress = (elapsed * Transitions::PROGRESS_MAX) / TRANSITION_DURATION;
+        Transitions::blend(transitionType, display.getFrameBuffer(), outgoingBuffer, incomingBuffer, progress);
+    }
+}
 
-        AnimationUtils::applyFade(fadeLevel);
+static void requestSwitch(AnimationType type) {
+    // Ignore requests for whatever is already (or about to be) on screen
+    AnimationType latest = transitionActive ? incomingAnimation : currentAnimation;
+    if (type == latest) {
+        switchPending = false;
+        return;
     }
+    
+    targetAnimation = type;
+    switchPending = true;
+    switchRequestTime = millis();
+    lastCycleTime = switchRequestTime;
 }
 
 void cycleToNextAnimation() {
     // Move to next animation
-    targetAnimation = (AnimationType)((currentAnimation + 1) % ANIM_COUNT);
-    
-    lastCycleTime = millis();
-    startFadeOut();
+    AnimationType latest = transitionActive ? incomingAnimation : currentAnimation;
+    requestSwitch((AnimationType)((latest + 1) % ANIM_COUNT));
 }
 
 void setAnimation(AnimationType type) {
     if (type >= ANIM_COUNT) return;
     
-    targetAnimation = type;
-    
-    lastCycleTime = millis();
-    startFadeOut();
+    requestSwitch(type);
 }
 
 AnimationType getCurrentAnimation() {
@@ -136,42 +342,77 @@ const char* getCurrentAnimationName() {
 }
 
 const char* getAnimationName(AnimationType type) {
-    switch(type) {
-        case ANIM_PLASMA:
-            return PlasmaAnimation::getName();
-        case ANIM_PARTICLES:
-            return ParticlesAnimation::getName();
-        case ANIM_FIRE:
-            return FireAnimation::getName();
-        case ANIM_GALAXY:
-            return GalaxyAnimation::getName();
-        case ANIM_STARS:
-            return StarAnimation::getName();
-        case ANIM_BEACH:
-            return BeachAnimation::getName();
-        case ANIM_DVD_LOGO:
-            return DVDLogoAnimation::getName();
-        default:
-            return "Unknown";
-    }
-}
-
-void startFadeOut() {
-    fadeActive = true;
-    fadeOut = true;
-    fadeStartTime = millis();
-}
-
-void startFadeIn() {
-    fadeActive = true;
-    fadeOut = false;
-    fadeStartTime = millis();
+    if (type >= ANIM_COUNT) return "Unknown";
+    
+    return ANIMATIONS[type]->name;
+}
+
+const AnimationDescriptor& getAnimationDescriptor(AnimationType type) {
+    return *ANIMATIONS[type < ANIM_COUNT ? type : ANIM_PLASMA];
+}
+
+size_t getAnimationStateSlotSize() {
+    return STATE_SLOT_SIZE;
+}
+
+size_t getAnimationStateArenaSize() {
+    return ((stateArena[0] ? 1 : 0) + (stateArena[1] ? 1 : 0)) * STATE_SLOT_SIZE;
+}
+
+size_t getAnimationStateTotalSize() {
+    size_t total = 0;
+    for (int i = 0; i < ANIM_COUNT; i++) {
+        total += ANIMATIONS[i]->stateSize;
+    }
+    return total;
+}
+
+size_t getTransitionBufferSize() {
+    return incomingBuffer ? 2 * BufferMatrixPanel::FRAME_BYTES : 0;
+}
+
+unsigned long getFrameInterval() {
+    return frameIntervalOf(currentAnimation);
+}
+
+void setTransitionType(TransitionType type) {
+    if (type >= TRANSITION_COUNT) return;
+    
+    transitionType = type;
+}
+
+TransitionType getTransitionType() {
+    return transitionType;
+}
+
+uint8_t getTransitionProgress() {
+    if (!transitionActive) {
+        return switchPending ? 0 : 100;
+    }
+    return min(100UL, (millis() - transitionStartTime) * 100 / TRANSITION_DURATION);
 }
 
 bool isFading() {
-    return fadeActive;
+    return transitionActive;
 }
 
 bool isAnimationFading() {
     return isFading();
+}
+
+void recordFrameTime(unsigned long micros) {
+    if (micros > worstFrameTime) {
+        worstFrameTime = micros;
+    }
+    if (transitionActive && micros > worstTransitionFrameTime) {
+        worstTransitionFrameTime = micros;
+    }
+}
+
+unsigned long getWorstFrameTime() {
+    return worstFrameTime;
+}
+
+unsigned long getWorstTransitionFrameTime() {
+    return worstTransitionFrameTime;
 }
\ No newline at end of file
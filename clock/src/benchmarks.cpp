@@ -0,0 +1,514 @@
+#include "benchmarks.h"
+
+#ifdef CLOCK_BENCHMARKS
+
+#include "animations_coordinator.h"
+#include "animation_utils.h"
+#include "display.h"
+#include "particles.h"
+#include "dvd_logo.h"
+#include "span_sprites.h"
+#include "alpha_sprites.h"
+#include <FastLED.h>
+
+static const uint32_t BENCH_FRAMES = 200;
+
+struct BenchResult {
+    uint32_t frames = 0;
+    unsigned long total = 0;
+    unsigned long worst = 0;
+
+    void add(unsigned long micros) {
+        frames++;
+        total += micros;
+        if (micros > worst) {
+            worst = micros;
+        }
+    }
+};
+
+static void report(const char* group, const char* name, const BenchResult& result) {
+    Serial.printf("BENCH %s %s frames=%u avg_us=%lu worst_us=%lu\n",
+                  group, name, (unsigned)result.frames,
+                  result.frames ? result.total / result.frames : 0, result.worst);
+}
+
+// Times `body(i)` for i in [0, frames)
+template <typename Body>
+static BenchResult timeFrames(uint32_t frames, Body body) {
+    BenchResult result;
+    for (uint32_t i = 0; i < frames; i++) {
+        unsigned long start = micros();
+        body(i);
+        result.add(micros() - start);
+    }
+    return result;
+}
+
+// Render cost of one animation on its own, then the full post-process and
+// push to the DMA output of the frames it draws
+static void benchAnimation(const AnimationDescriptor& animation, const char* variant) {
+    char name[40];
+    snprintf(name, sizeof(name), "%s%s", animation.name, variant);
+
+    void* memory = malloc(animation.stateSize ? animation.stateSize : 1);
+    if (!memory) {
+        Serial.printf("BENCH render %s skipped (no memory)\n", name);
+        return;
+    }
+
+    display.clearData();
+    display.setAntialiasMode(animation.antialias);
+    animation.init(memory);
+
+    BenchResult render, flip;
+    for (uint32_t frame = 1; frame <= BENCH_FRAMES; frame++) {
+        unsigned long start = micros();
+        animation.render(frame);
+        render.add(micros() - start);
+
+        // Make the flip do the full work even if the frame didn't change
+        display.invalidateFrame();
+        start = micros();
+        display.flip();
+        flip.add(micros() - start);
+    }
+
+    report("render", name, render);
+    report("flip", name, flip);
+    Serial.printf("BENCH heap %s accumulation_bytes=%u\n", name, (unsigned)Accumulation::getAllocatedSize());
+
+    animation.teardown();
+    free(memory);
+    display.clearData();
+    display.invalidateFrame();
+}
+
+static void benchAnimations() {
+    for (int i = 0; i < ANIM_COUNT; i++) {
+        benchAnimation(getAnimationDescriptor((AnimationType)i), "");
+    }
+    
+    // Trail animations again on the plain RGB565 path
+    Accumulation::setEnabled(false);
+    benchAnimation(getAnimationDescriptor(ANIM_GALAXY), " (565)");
+    benchAnimation(getAnimationDescriptor(ANIM_PARTICLES), " (565)");
+    Accumulation::setEnabled(true);
+    
+    // Stars again at increasing star counts
+    uint16_t starCount = StarAnimation::getStarCount();
+    for (uint16_t count = 100; count <= StarAnimation::MAX_STARS; count *= 2) {
+        char variant[16];
+        snprintf(variant, sizeof(variant), " (%u)", (unsigned)count);
+        StarAnimation::setStarCount(count);
+        benchAnimation(getAnimationDescriptor(ANIM_STARS), variant);
+    }
+    StarAnimation::setStarCount(starCount);
+}
+
+// What a switch costs in the frame it happens: init() from nothing, and
+// init() after prepare() has run to completion a call at a time, as the
+// coordinator does during idle time
+static void benchInit(const AnimationDescriptor& animation) {
+    void* memory = malloc(animation.stateSize ? animation.stateSize : 1);
+    if (!memory) {
+        Serial.printf("BENCH init %s skipped (no memory)\n", animation.name);
+        return;
+    }
+    
+    unsigned long start = micros();
+    animation.init(memory);
+    unsigned long cold = micros() - start;
+    animation.teardown();
+    
+    BenchResult prepare;
+    if (animation.prepare) {
+        bool ready = false;
+        while (!ready) {
+            start = micros();
+            ready = animation.prepare(memory);
+            prepare.add(micros() - start);
+        }
+    }
+    start = micros();
+    animation.init(memory);
+    unsigned long warm = micros() - start;
+    animation.teardown();
+    free(memory);
+    
+    Serial.printf("BENCH init %s cold_us=%lu prepared_us=%lu prepare_calls=%u prepare_worst_us=%lu\n",
+                  animation.name, cold, warm, (unsigned)prepare.frames, prepare.worst);
+}
+
+static void benchInits() {
+    for (int i = 0; i < ANIM_COUNT; i++) {
+        benchInit(getAnimationDescriptor((AnimationType)i));
+    }
+}
+
+// The float circles AnimationUtils had before the integer scanline ones,
+// kept as the baseline for them
+static void legacyDrawCircle(float xCenter, float yCenter, float radius, uint16_t color, uint8_t alpha) {
+    int x0 = round(xCenter);
+    int y0 = round(yCenter);
+    int r0 = round(radius);
+    
+    int x = r0;
+    int y = 0;
+    int err = 0;
+
+    while (x >= y) {
+        float weight = 1.0f - (sqrt((x - radius) * (x - radius) + (y) * (y)) / radius);
+        uint8_t pixelAlpha = (uint8_t)(alpha * weight);
+        
+        AnimationUtils::drawPixelWithBlend(x0 + x, y0 + y, color, pixelAlpha);
+        AnimationUtils::drawPixelWithBlend(x0 + y, y0 + x, color, pixelAlpha);
+        AnimationUtils::drawPixelWithBlend(x0 - y, y0 + x, color, pixelAlpha);
+        AnimationUtils::drawPixelWithBlend(x0 - x, y0 + y, color, pixelAlpha);
+        AnimationUtils::drawPixelWithBlend(x0 - x, y0 - y, color, pixelAlpha);
+        AnimationUtils::drawPixelWithBlend(x0 - y, y0 - x, color, pixelAlpha);
+        AnimationUtils::drawPixelWithBlend(x0 + y, y0 - x, color, pixelAlpha);
+        AnimationUtils::drawPixelWithBlend(x0 + x, y0 - y, color, pixelAlpha);
+
+        if (err <= 0) {
+            y += 1;
+            err += 2*y + 1;
+        }
+        if (err > 0) {
+            x -= 1;
+            err -= 2*x + 1;
+        }
+    }
+}
+
+static void legacyFillCircle(float xCenter, float yCenter, float radius, uint16_t color, uint8_t alpha) {
+    int x0 = round(xCenter);
+    int y0 = round(yCenter);
+    float radiusSquared = radius * radius;
+
+    for (float dy = -radius; dy <= radius; dy += 1.0f) {
+        float dx = sqrt(radiusSquared - dy * dy);
+        int y = round(y0 + dy);
+        
+        for (float x = -dx; x <= dx; x += 1.0f) {
+            int xPos = round(x0 + x);
+            float distanceFromCenter = sqrt(x * x + dy * dy);
+            float weight = 1.0f - (distanceFromCenter / radius);
+            weight = max(0.0f, min(1.0f, weight));
+            
+            uint8_t pixelAlpha = (uint8_t)(alpha * weight);
+            AnimationUtils::drawPixelWithBlend(xPos, y, color, pixelAlpha);
+        }
+    }
+}
+
+// Circle primitives against the float versions, opaque and blended, from
+// radius 1 to 32. Centred on the display, so large radii also clip.
+static void benchCircles() {
+    const int cx = DISPLAY_WIDTH / 2, cy = DISPLAY_HEIGHT / 2;
+    for (int radius = 1; radius <= 32; radius *= 2) {
+        for (int alpha = 255; alpha >= 128; alpha -= 127) {
+            char name[40];
+            snprintf(name, sizeof(name), "fill r=%d a=%d (float)", radius, alpha);
+            report("circle", name, timeFrames(BENCH_FRAMES, [&](uint32_t) {
+                legacyFillCircle(cx, cy, radius, 0x07E0, alpha);
+            }));
+            snprintf(name, sizeof(name), "fill r=%d a=%d", radius, alpha);
+            report("circle", name, timeFrames(BENCH_FRAMES, [&](uint32_t) {
+                AnimationUtils::fillCircle(cx, cy, radius, 0x07E0, alpha);
+            }));
+            snprintf(name, sizeof(name), "outline r=%d a=%d (float)", radius, alpha);
+            report("circle", name, timeFrames(BENCH_FRAMES, [&](uint32_t) {
+                legacyDrawCircle(cx, cy, radius, 0x07E0, alpha);
+            }));
+            snprintf(name, sizeof(name), "outline r=%d a=%d", radius, alpha);
+            report("circle", name, timeFrames(BENCH_FRAMES, [&](uint32_t) {
+                AnimationUtils::drawCircle(cx, cy, radius, 0x07E0, alpha);
+            }));
+        }
+    }
+    display.clearData();
+    display.invalidateFrame();
+}
+
+// Line primitives at a thousand lines (or two hundred arcs) per frame, with
+// endpoints spread over the display
+static void benchLines() {
+    const int LINES = 1000;
+    int16_t* points = (int16_t*)malloc(LINES * 4 * sizeof(int16_t));
+    if (!points) {
+        Serial.println("BENCH lines skipped (no memory)");
+        return;
+    }
+    for (int i = 0; i < LINES * 4; i += 2) {
+        points[i] = random(DISPLAY_WIDTH);
+        points[i + 1] = random(DISPLAY_HEIGHT);
+    }
+    
+    for (int width = 1; width <= 3; width += 2) {
+        char name[24];
+        snprintf(name, sizeof(name), "%d width=%d", LINES, width);
+        report("lines", name, timeFrames(BENCH_FRAMES, [&](uint32_t) {
+            for (int i = 0; i < LINES * 4; i += 4) {
+                AnimationUtils::drawLine(points[i], points[i + 1], points[i + 2], points[i + 3], 0x07E0, 200, width);
+            }
+        }));
+    }
+    report("lines", "polyline 1000", timeFrames(BENCH_FRAMES, [&](uint32_t) {
+        AnimationUtils::drawPolyline(points, LINES, 0x07E0, 200);
+    }));
+    report("lines", "arcs 200", timeFrames(BENCH_FRAMES, [&](uint32_t) {
+        for (int i = 0; i < 200; i++) {
+            AnimationUtils::drawArc(points[2 * i], points[2 * i + 1], 4 + i % 24, i * 997, 16384 + i * 191, 0x07E0, 200);
+        }
+    }));
+    
+    free(points);
+    display.clearData();
+    display.invalidateFrame();
+}
+
+// The DVD logo drawn bit by bit from its bitmap against its span sprite,
+// a hundred per frame along the diagonal (some of them clipped), and the
+// alpha sprites
+static void benchSprites() {
+    const int LOGOS = 100;
+    report("sprite", "dvd bitmap x100", timeFrames(BENCH_FRAMES, [&](uint32_t) {
+        for (int i = 0; i < LOGOS; i++) {
+            AnimationUtils::drawBitmapTransparent(i * DISPLAY_WIDTH / LOGOS - 8, i * DISPLAY_HEIGHT / LOGOS - 8,
+                                                  dvd_logo_bitmap, dvdLogoImageWidth, dvdLogoImageHeight, 0xF800);
+        }
+    }));
+    report("sprite", "dvd spans x100", timeFrames(BENCH_FRAMES, [&](uint32_t) {
+        for (int i = 0; i < LOGOS; i++) {
+            AnimationUtils::drawSprite(i * DISPLAY_WIDTH / LOGOS - 8, i * DISPLAY_HEIGHT / LOGOS - 8, DVD_LOGO_SPRITE, 0xF800);
+        }
+    }));
+    report("sprite", "dvd spans a=128 x100", timeFrames(BENCH_FRAMES, [&](uint32_t) {
+        for (int i = 0; i < LOGOS; i++) {
+            AnimationUtils::drawSprite(i * DISPLAY_WIDTH / LOGOS - 8, i * DISPLAY_HEIGHT / LOGOS - 8, DVD_LOGO_SPRITE, 0xF800, 128);
+        }
+    }));
+    
+    // A flock of seabirds (Beach), plotted a pixel at a time as they used to
+    // be against alpha sprites, opaque and faded and flipped
+    const int BIRDS = 48;
+    const int8_t BIRD[11][2] = {
+        {-3, 0}, {-2, 0}, {-2, -1}, {0, -1}, {0, 0}, {1, 0}, {2, -1}, {2, 0}, {3, 0}, {1, 1}, {2, 1}
+    };
+    report("sprite", "seabird pixels x48", timeFrames(BENCH_FRAMES, [&](uint32_t frame) {
+        for (int i = 0; i < BIRDS; i++) {
+            int x = (i * 37 + frame) % DISPLAY_WIDTH, y = i * DISPLAY_HEIGHT / BIRDS;
+            for (int p = 0; p < 11; p++) {
+                display.drawPixel(x + BIRD[p][0], y + BIRD[p][1], 0);
+            }
+        }
+    }));
+    for (int alpha = 255; alpha >= 128; alpha -= 127) {
+        char name[40];
+        snprintf(name, sizeof(name), "seabird alpha a=%d x48", alpha);
+        report("sprite", name, timeFrames(BENCH_FRAMES, [&](uint32_t frame) {
+            for (int i = 0; i < BIRDS; i++) {
+                int x = (i * 37 + frame) % DISPLAY_WIDTH, y = i * DISPLAY_HEIGHT / BIRDS;
+                AnimationUtils::drawSprite(x - 3, y - 1, SEABIRD_SPRITE, alpha, i & 1 ? SPRITE_FLIP_X : 0);
+            }
+        }));
+    }
+    display.clearData();
+    display.invalidateFrame();
+}
+
+// Particle engine passes against the number of live particles
+static void benchParticles() {
+    Particles::Pool pool;
+    uint32_t* accumulation = Accumulation::allocate();
+    if (!Particles::allocate(pool, 2000)) {
+        Serial.println("BENCH particles skipped (no memory)");
+        Accumulation::release(accumulation);
+        return;
+    }
+    
+    for (uint16_t count = 250; count <= pool.capacity; count *= 2) {
+        // Slow particles spread over the display, so few leave during the run
+        pool.count = 0;
+        for (uint16_t i = 0; i < count; i++) {
+            Particles::spawn(pool, random(DISPLAY_WIDTH << Particles::POSITION_SHIFT),
+                             random(DISPLAY_HEIGHT << Particles::POSITION_SHIFT),
+                             random(-6, 7), random(-6, 7), 255, (uint16_t)random(0x10000));
+        }
+        
+        char name[24];
+        snprintf(name, sizeof(name), "update %u", (unsigned)count);
+        report("particles", name, timeFrames(BENCH_FRAMES, [&](uint32_t) {
+            Particles::update(pool);
+        }));
+        snprintf(name, sizeof(name), "draw %u", (unsigned)count);
+        report("particles", name, timeFrames(BENCH_FRAMES, [&](uint32_t) {
+            Particles::draw(pool, accumulation);
+        }));
+    }
+    
+    Particles::release(pool);
+    Accumulation::release(accumulation);
+}
+
+// Plasma as it was drawn before the sine tables and palette: three sines and
+// a float HSL conversion per pixel. Kept as the timing baseline and golden.
+static void plasmaReference(uint32_t frame, uint16_t* out) {
+    float plasmaTime = (frame % 6280) * 0.1f;
+    for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+        for (int x = 0; x < DISPLAY_WIDTH; x++) {
+            uint16_t angle1 = (uint16_t)(int32_t)((x * 0.08f + plasmaTime) * 10430.0f);
+            uint16_t angle2 = (uint16_t)(int32_t)((y * 0.08f + plasmaTime * 1.2f) * 10430.0f);
+            uint16_t angle3 = (uint16_t)(int32_t)(((x + y) * 0.04f + plasmaTime * 0.8f) * 10430.0f);
+            
+            float plasma = (sin16(angle1) / 32767.0f + sin16(angle2) / 32767.0f + sin16(angle3) / 32767.0f) / 3.0f;
+            
+            float hue = 280 + plasma * 80;
+            while (hue < 0) hue += 360.0f;
+            while (hue >= 360.0f) hue -= 360.0f;
+            
+            uint8_t r, g, b;
+            AnimationUtils::hslToRgb(hue / 360.0f, 0.7f + plasma * 0.3f, 0.4f + plasma * 0.3f, &r, &g, &b);
+            out[y * DISPLAY_WIDTH + x] = AnimationUtils::rgb888To565(r, g, b);
+        }
+    }
+}
+
+// Largest difference of one RGB565 channel, in steps of that channel
+static int channelDiff(uint16_t a, uint16_t b) {
+    int dr = abs((a >> 11) - (b >> 11));
+    int dg = abs(((a >> 5) & 0x3F) - ((b >> 5) & 0x3F));
+    int db = abs((a & 0x1F) - (b & 0x1F));
+    return max(dr, max(dg, db));
+}
+
+// Plasma against its per-pixel float reference, for speed and output
+static void benchPlasma() {
+    const AnimationDescriptor& plasma = getAnimationDescriptor(ANIM_PLASMA);
+    uint16_t* reference = (uint16_t*)malloc(BufferMatrixPanel::FRAME_BYTES);
+    void* memory = malloc(plasma.stateSize);
+    if (!reference || !memory) {
+        Serial.println("BENCH golden Plasma skipped (no memory)");
+        free(reference);
+        free(memory);
+        return;
+    }
+    
+    report("render", "Plasma (float)", timeFrames(BENCH_FRAMES, [&](uint32_t i) {
+        plasmaReference(i + 1, reference);
+    }));
+    
+    // Frames spread over the whole 628 second cycle
+    plasma.init(memory);
+    uint32_t pixels = 0, identical = 0;
+    int worst = 0;
+    for (uint32_t frame = 1; frame < 6280; frame += 157) {
+        plasma.render(frame);
+        plasmaReference(frame, reference);
+        
+        const uint16_t* rendered = display.getFrameBuffer();
+        for (int i = 0; i < DISPLAY_WIDTH * DISPLAY_HEIGHT; i++) {
+            int diff = channelDiff(rendered[i], reference[i]);
+            worst = max(worst, diff);
+            identical += diff == 0;
+            pixels++;
+        }
+    }
+    Serial.printf("BENCH golden Plasma pixels=%u identical_pct=%u worst_step=%d\n",
+                  (unsigned)pixels, (unsigned)(identical * 100ULL / pixels), worst);
+    
+    plasma.teardown();
+    free(memory);
+    free(reference);
+    display.clearData();
+    display.invalidateFrame();
+}
+
+// Whole-frame kernels in isolation, on a busy frame
+static void benchKernels() {
+    uint16_t* frame = display.getFrameBuffer();
+    uint16_t* incoming = (uint16_t*)malloc(BufferMatrixPanel::FRAME_BYTES);
+    if (!incoming) {
+        Serial.println("BENCH kernels skipped (no memory)");
+        return;
+    }
+    for (int i = 0; i < DISPLAY_WIDTH * DISPLAY_HEIGHT; i++) {
+        frame[i] = (uint16_t)(i * 2654435761u >> 16);
+        incoming[i] = ~frame[i];
+    }
+
+    report("kernel", "tileSignatures", timeFrames(BENCH_FRAMES, [&](uint32_t) {
+        for (int tile = 0; tile < BufferMatrixPanel::TILES; tile++) {
+            display.tileSignature(tile);
+        }
+    }));
+    report("kernel", "applyAntialiasing", timeFrames(BENCH_FRAMES, [&](uint32_t) {
+        display.applyAntialiasing();
+    }));
+    report("kernel", "applyFade", timeFrames(BENCH_FRAMES, [&](uint32_t) {
+        AnimationUtils::applyFade(255 - 35);
+    }));
+    
+    // Indexed frames: expanding through a palette, and fading one
+    uint16_t palette[256];
+    for (int i = 0; i < 256; i++) {
+        palette[i] = (uint16_t)(i * 0x0101);
+    }
+    report("kernel", "resolveIndexed", timeFrames(BENCH_FRAMES, [&](uint32_t i) {
+        display.resolveIndexed(palette, i);
+    }));
+    report("kernel", "fadePalette", timeFrames(BENCH_FRAMES, [&](uint32_t i) {
+        AnimationUtils::fadePalette(palette, palette, 250);
+    }));
+    
+    // Full push to the DMA output under each dither mode
+    DitherMode ditherMode = display.getDitherMode();
+    uint8_t ditherBits = display.getDitherBits();
+    for (int mode = 0; mode < DITHER_COUNT; mode++) {
+        display.setDither((DitherMode)mode, ditherBits < 6 ? ditherBits : 4);
+        report("flip", Dither::getName((DitherMode)mode), timeFrames(BENCH_FRAMES, [&](uint32_t) {
+            display.invalidateFrame();
+            display.flip();
+        }));
+    }
+    display.setDither(ditherMode, ditherBits);
+    
+    // Transitions compose the frame from two off-screen buffers
+    uint16_t* outgoing = (uint16_t*)malloc(BufferMatrixPanel::FRAME_BYTES);
+    if (outgoing) {
+        memcpy(outgoing, frame, BufferMatrixPanel::FRAME_BYTES);
+        for (int t = 0; t < TRANSITION_COUNT; t++) {
+            report("transition", Transitions::getName((TransitionType)t), timeFrames(BENCH_FRAMES, [&](uint32_t i) {
+                Transitions::blend((TransitionType)t, frame, outgoing, incoming,
+                                   (i * Transitions::PROGRESS_MAX) / BENCH_FRAMES);
+            }));
+        }
+        free(outgoing);
+    }
+
+    free(incoming);
+    display.clearData();
+    display.invalidateFrame();
+}
+
+void runBenchmarks() {
+    Serial.printf("BENCH start %dx%d panels=%d hot_iram=%d\n", DISPLAY_WIDTH, DISPLAY_HEIGHT, PANEL_CHAIN,
+#if defined(CLOCK_HOT_IRAM) && CLOCK_HOT_IRAM
+                  1
+#else
+                  0
+#endif
+                  );
+    benchKernels();
+    benchCircles();
+    benchLines();
+    benchSprites();
+    benchAnimations();
+    benchInits();
+    benchPlasma();
+    benchParticles();
+    Serial.println("BENCH done");
+}
+
+#endif // CLOCK_BENCHMARKS
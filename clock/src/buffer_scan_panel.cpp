@@ -1,75 +1,205 @@
 #include "buffer_scan_panel.h"
 #include "animation_utils.h"
 
-void BufferMatrixPanel::drawPixel(int16_t x, int16_t y, uint16_t color) {
-  if (x < 0 || x >= DISPLAY_WIDTH || y < 0 || y >= DISPLAY_HEIGHT) {
+template <int W, int H, int TILE_W, int TILE_H, PANEL_CHAIN_TYPE CHAIN>
+void BufferMatrixPanelT<W, H, TILE_W, TILE_H, CHAIN>::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || x >= W || y < 0 || y >= H) {
     return;
   }
-  pixelData[x][y] = color;
+  target[y * W + x] = color;
 }
 
-void BufferMatrixPanel::drawPixelRGB888(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b) {
+template <int W, int H, int TILE_W, int TILE_H, PANEL_CHAIN_TYPE CHAIN>
+void BufferMatrixPanelT<W, H, TILE_W, TILE_H, CHAIN>::drawPixelRGB888(int16_t x, int16_t y, uint8_t r, uint8_t g, uint8_t b) {
   uint16_t color = AnimationUtils::rgb888To565(r, g, b);
   drawPixel(x,y,color);
 }
 
-void BufferMatrixPanel::applyAntialiasing() {
-  // Create a temporary buffer for the antialiased result
-  static uint16_t tempBuffer[DISPLAY_WIDTH][DISPLAY_HEIGHT];
+template <int W, int H, int TILE_W, int TILE_H, PANEL_CHAIN_TYPE CHAIN>
+uint32_t CLOCK_HOT_PATH BufferMatrixPanelT<W, H, TILE_W, TILE_H, CHAIN>::tileSignature(int tile) const {
+  // FNV-1a over pixel pairs; one read pass, much cheaper than the
+  // antialiasing pass and the DMA push it lets us skip.
+  const uint16_t* pixels = pixelData + (tile / TILE_COLS) * TILE_H * W + (tile % TILE_COLS) * TILE_W;
+  uint32_t hash = 2166136261u;
+  for (int y = 0; y < TILE_H; y++, pixels += W) {
+    for (int x = 0; x < TILE_W; x += 2) {
+      hash = (hash ^ (pixels[x] | ((uint32_t)pixels[x + 1] << 16))) * 16777619u;
+    }
+  }
+  return hash;
+}
+
+template <int W, int H, int TILE_W, int TILE_H, PANEL_CHAIN_TYPE CHAIN>
+void CLOCK_HOT_PATH BufferMatrixPanelT<W, H, TILE_W, TILE_H, CHAIN>::flip() {
+  // A tile that hasn't changed since it was last pushed already shows exactly
+  // what antialiasing would produce. Its buffer keeps the composed pixels
+  // rather than the filtered ones, which only matters to animations that
+  // fade the previous frame, and those rarely repeat a frame exactly.
+  bool dirty[TILES];
+  bool anyDirty = false;
+  bool temporal = ditherMode == DITHER_TEMPORAL;
+  for (int tile = 0; tile < TILES; tile++) {
+    uint32_t signature = tileSignature(tile);
+    dirty[tile] = temporal || !tileValid[tile] || signature != tileSignatures[tile];
+    tileSignatures[tile] = signature;
+    tileValid[tile] = true;
+    anyDirty |= dirty[tile];
+  }
+  if (!anyDirty) {
+    skippedFrames++;
+    skippedTiles += TILES;
+    return;
+  }
+  flippedFrames++;
+
+  // Antialiasing reaches one pixel into the neighbouring tiles, so the edges
+  // of an unchanged tile next to a changed one change too
+  bool update[TILES];
+  for (int tile = 0; tile < TILES; tile++) {
+    update[tile] = dirty[tile];
+    if (antialiasMode == AA_NONE || dirty[tile]) continue;
+
+    int row = tile / TILE_COLS;
+    int col = tile % TILE_COLS;
+    for (int r = max(0, row - 1); r <= min(TILE_ROWS - 1, row + 1); r++) {
+      for (int c = max(0, col - 1); c <= min(TILE_COLS - 1, col + 1); c++) {
+        update[tile] |= dirty[r * TILE_COLS + c];
+      }
+    }
+  }
+
+  if (antialiasMode == AA_BOX_3X3) {
+    applyAntialiasing(update);
+  }
+  for (int tile = 0; tile < TILES; tile++) {
+    if (update[tile]) {
+      pushTile(tile);
+      pushedTiles++;
+    } else {
+      skippedTiles++;
+    }
+  }
+  ditherFrame++;
+}
+
+template <int W, int H, int TILE_W, int TILE_H, PANEL_CHAIN_TYPE CHAIN>
+void CLOCK_HOT_PATH BufferMatrixPanelT<W, H, TILE_W, TILE_H, CHAIN>::pushTile(int tile) {
+  int x0 = (tile % TILE_COLS) * TILE_W;
+  int y0 = (tile / TILE_COLS) * TILE_H;
+  const uint16_t* pixels = pixelData + y0 * W + x0;
   
-  // Copy current data to temp buffer
-  for (int x = 0; x < DISPLAY_WIDTH; x++) {
-    for (int y = 0; y < DISPLAY_HEIGHT; y++) {
-      tempBuffer[x][y] = pixelData[x][y];
+  // Gamma correct each channel to 16 bits, add the dither offset and
+  // truncate to the output depth, so the DMA's dropped low bits don't band.
+  // The library's own correction is off (NO_CIE1931), so this is the only one.
+  uint8_t mask = 0xFF << (8 - ditherBits);
+  uint16_t offsets[8];
+  for (int y = 0; y < TILE_H; y++, pixels += W) {
+    Dither::rowOffsets(ditherMode, ditherBits, y0 + y, ditherFrame, offsets);
+    for (int x = 0; x < TILE_W; x++) {
+      uint16_t pixel = pixels[x];
+      uint16_t offset = offsets[(x0 + x) & 7];
+      Output::drawPixelRGB888(x0 + x, y0 + y,
+                              Dither::apply(Dither::GAMMA_5[pixel >> 11], offset, mask),
+                              Dither::apply(Dither::GAMMA_6[(pixel >> 5) & 0x3F], offset, mask),
+                              Dither::apply(Dither::GAMMA_5[pixel & 0x1F], offset, mask));
     }
   }
+}
+
+template <int W, int H, int TILE_W, int TILE_H, PANEL_CHAIN_TYPE CHAIN>
+void CLOCK_HOT_PATH BufferMatrixPanelT<W, H, TILE_W, TILE_H, CHAIN>::resolveIndexed(const uint16_t* palette, uint8_t rotate) {
+  uint16_t faded[256];
+  if (paletteLevel < 255) {
+    AnimationUtils::fadePalette(faded, palette, paletteLevel);
+    palette = faded;
+  }
   
-  // Apply simple 3x3 box filter antialiasing
-  for (int x = 1; x < DISPLAY_WIDTH - 1; x++) {
-    for (int y = 1; y < DISPLAY_HEIGHT - 1; y++) {
-      // Extract RGB components from surrounding pixels
-      uint32_t totalR = 0, totalG = 0, totalB = 0;
-      int count = 0;
-      
-      // Sample 3x3 neighborhood
-      for (int dx = -1; dx <= 1; dx++) {
-        for (int dy = -1; dy <= 1; dy++) {
-          uint16_t pixel = tempBuffer[x + dx][y + dy];
-          
-          // Convert RGB565 to RGB888 for averaging
-          uint8_t r = (pixel >> 11) & 0x1F;
-          uint8_t g = (pixel >> 5) & 0x3F;
-          uint8_t b = pixel & 0x1F;
-          
-          // Scale to 8-bit
-          r = (r * 255) / 31;
-          g = (g * 255) / 63;
-          b = (b * 255) / 31;
-          
-          totalR += r;
-          totalG += g;
-          totalB += b;
-          count++;
-        }
-      }
+  // Back to front, so each 16-bit pixel only overwrites indices already read
+  const uint8_t* indices = getIndexedTarget();
+  for (int i = W * H - 1; i >= 0; i--) {
+    target[i] = palette[(uint8_t)(indices[i] + rotate)];
+  }
+}
+
+// 3x3 box filter blended 50% with the centre pixel, for pixel x of `row`
+static inline uint16_t filterPixel(const uint16_t* above, const uint16_t* row, const uint16_t* below, int x) {
+  // Extract RGB components from surrounding pixels
+  uint32_t totalR = 0, totalG = 0, totalB = 0;
+  const uint16_t* rows[3] = {above, row, below};
+  
+  // Sample 3x3 neighborhood
+  for (int dx = -1; dx <= 1; dx++) {
+    for (int dy = 0; dy < 3; dy++) {
+      uint16_t pixel = rows[dy][x + dx];
       
-      // Average the colors
-      uint8_t avgR = totalR / count;
-      uint8_t avgG = totalG / count;
-      uint8_t avgB = totalB / count;
+      // Convert RGB565 to RGB888 for averaging
+      uint8_t r = (pixel >> 11) & 0x1F;
+      uint8_t g = (pixel >> 5) & 0x3F;
+      uint8_t b = pixel & 0x1F;
       
-      // Blend with original pixel (50% antialiasing strength)
-      uint16_t originalPixel = tempBuffer[x][y];
-      uint8_t origR = ((originalPixel >> 11) & 0x1F) * 255 / 31;
-      uint8_t origG = ((originalPixel >> 5) & 0x3F) * 255 / 63;
-      uint8_t origB = (originalPixel & 0x1F) * 255 / 31;
+      // Scale to 8-bit
+      r = (r * 255) / 31;
+      g = (g * 255) / 63;
+      b = (b * 255) / 31;
       
-      uint8_t finalR = (origR + avgR) / 2;
-      uint8_t finalG = (origG + avgG) / 2;
-      uint8_t finalB = (origB + avgB) / 2;
+      totalR += r;
+      totalG += g;
+      totalB += b;
+    }
+  }
+  
+  // Average the colors
+  uint8_t avgR = totalR / 9;
+  uint8_t avgG = totalG / 9;
+  uint8_t avgB = totalB / 9;
+  
+  // Blend with original pixel (50% antialiasing strength)
+  uint16_t originalPixel = row[x];
+  uint8_t origR = ((originalPixel >> 11) & 0x1F) * 255 / 31;
+  uint8_t origG = ((originalPixel >> 5) & 0x3F) * 255 / 63;
+  uint8_t origB = (originalPixel & 0x1F) * 255 / 31;
+  
+  uint8_t finalR = (origR + avgR) / 2;
+  uint8_t finalG = (origG + avgG) / 2;
+  uint8_t finalB = (origB + avgB) / 2;
+  
+  // Convert back to RGB565
+  return AnimationUtils::rgb888To565(finalR, finalG, finalB);
+}
+
+template <int W, int H, int TILE_W, int TILE_H, PANEL_CHAIN_TYPE CHAIN>
+void CLOCK_HOT_PATH BufferMatrixPanelT<W, H, TILE_W, TILE_H, CHAIN>::applyAntialiasing(const bool* tiles) {
+  // The filter runs down the frame in place. Only the unfiltered copies of
+  // the row above and the current row need keeping; the row below hasn't
+  // been touched yet.
+  static uint16_t lines[2][W];
+  uint16_t* above = lines[0];
+  uint16_t* row = lines[1];
+  
+  memcpy(above, pixelData, sizeof(lines[0]));
+  for (int y = 1; y < H - 1; y++) {
+    uint16_t* out = pixelData + y * W;
+    memcpy(row, out, sizeof(lines[0]));
+    
+    const bool* tileRow = tiles ? tiles + (y / TILE_H) * TILE_COLS : nullptr;
+    for (int col = 0; col < TILE_COLS; col++) {
+      if (tileRow && !tileRow[col]) continue;
       
-      // Convert back to RGB565
-      pixelData[x][y] = AnimationUtils::rgb888To565(finalR, finalG, finalB);
+      // The outermost pixels of the frame are left as they are
+      int start = max(1, col * TILE_W);
+      int end = min(W - 1, (col + 1) * TILE_W);
+      for (int x = start; x < end; x++) {
+        out[x] = filterPixel(above, row, out + W, x);
+      }
     }
+    
+    uint16_t* swap = above;
+    above = row;
+    row = swap;
   }
-}
\ No newline at end of file
+}
+
+// Only the configured display is built; override DISPLAY_WIDTH/DISPLAY_HEIGHT
+// and the panel layout for others (see the bench envs in platformio.ini)
+template class BufferMatrixPanelT<DISPLAY_WIDTH, DISPLAY_HEIGHT,
+                                  PANEL_RES_X, PANEL_RES_Y, DISPLAY_CHAIN_LAYOUT>;
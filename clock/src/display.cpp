@@ -1,6 +1,6 @@
 #include "display.h"
 
-HUB75_I2S_CFG mxconfig(DISPLAY_WIDTH, DISPLAY_HEIGHT, 1, 
+HUB75_I2S_CFG mxconfig(PANEL_RES_X, PANEL_RES_Y, PANEL_CHAIN, 
                        {R1_PIN, G1_PIN, B1_PIN, R2_PIN, G2_PIN, B2_PIN, A_PIN,
                         B_PIN, C_PIN, D_PIN, E_PIN, LAT_PIN, OE_PIN, CLK_PIN},
                         HUB75_I2S_CFG::shift_driver::FM6124,
@@ -9,7 +9,7 @@ HUB75_I2S_CFG mxconfig(DISPLAY_WIDTH, DISPLAY_HEIGHT, 1,
 MatrixPanel_I2S_DMA dmaOutput(mxconfig);
 
 // Create a virtual display panel for rendering
-BufferMatrixPanel display(1, 1, DISPLAY_WIDTH, DISPLAY_HEIGHT);
+BufferMatrixPanel display(PANEL_ROWS, PANEL_COLS, PANEL_RES_X, PANEL_RES_Y);
 
 void displayInit() {
   dmaOutput.begin();
@@ -17,4 +17,5 @@ void displayInit() {
   dmaOutput.setBrightness(170);
   display.setDisplay(dmaOutput);
   display.clearScreen();
+  display.invalidateFrame();
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "dither.h"
+
+namespace Dither {
+    const uint8_t BAYER_8X8[8][8] = {
+        { 0, 32,  8, 40,  2, 34, 10, 42},
+        {48, 16, 56, 24, 50, 18, 58, 26},
+        {12, 44,  4, 36, 14, 46,  6, 38},
+        {60, 28, 52, 20, 62, 30, 54, 22},
+        { 3, 35, 11, 43,  1, 33,  9, 41},
+        {51, 19, 59, 27, 49, 17, 57, 25},
+        {15, 47,  7, 39, 13, 45,  5, 37},
+        {63, 31, 55, 23, 61, 29, 53, 21}
+    };
+
+    // 255 * level / 31 (or 63) through the CIE1931 curve, scaled to 65535
+    const uint16_t GAMMA_5[32] = {
+            0,   228,   455,   689,  1018,  1386,  1834,  2369,
+         3085,  3831,  4689,  5666,  6918,  8175,  9576, 11128,
+        13065, 14965, 17041, 19300, 22071, 24746, 27629, 30728,
+        34481, 38064, 41887, 45957, 50843, 55465, 60360, 65535
+    };
+
+    const uint16_t GAMMA_6[64] = {
+            0,   114,   228,   341,   455,   569,   689,   825,
+          977,  1147,  1336,  1544,  1773,  2024,  2297,  2593,
+         2999,  3352,  3732,  4139,  4575,  5041,  5537,  6065,
+         6626,  7220,  7848,  8512,  9212,  9949, 10725, 11541,
+        12617, 13524, 14474, 15467, 16505, 17588, 18717, 19894,
+        21119, 22394, 23719, 25095, 26523, 28004, 29540, 31131,
+        33198, 34916, 36693, 38529, 40425, 42382, 44401, 46484,
+        48631, 50843, 53120, 55465, 57878, 60360, 62912, 65535
+    };
+
+    void rowOffsets(DitherMode mode, uint8_t bits, int y, uint32_t frame, uint16_t offsets[8]) {
+        // One output step in 16-bit terms; offsets stay below it
+        uint32_t step = 1UL << (16 - bits);
+        
+        // Temporal dithering moves every threshold a quarter of the range
+        // each frame, so over 4 frames each pixel averages out in between
+        // output levels instead of sitting on one side of its threshold.
+        uint8_t shift = mode == DITHER_TEMPORAL ? (frame & 3) * 16 : 0;
+        
+        const uint8_t* thresholds = BAYER_8X8[y & 7];
+        for (int x = 0; x < 8; x++) {
+            offsets[x] = mode == DITHER_NONE ? 0 : (((thresholds[x] + shift) & 63) * step) >> 6;
+        }
+    }
+
+    const char* getName(DitherMode mode) {
+        switch(mode) {
+            case DITHER_NONE:
+                return "None";
+            case DITHER_ORDERED:
+                return "Ordered";
+            case DITHER_TEMPORAL:
+                return "Temporal";
+            default:
+                return "Unknown";
+        }
+    }
+}
@@ -1,3 +1,6 @@
+// The firmware itself; unit tests (test/) bring their own setup() and loop()
+#ifndef PIO_UNIT_TESTING
+
 #include <Arduino.h>
 #include <AsyncTCP.h>
 #include <WiFi.h>
@@ -15,6 +18,8 @@
 
 #include "display.h"
 #include "animations_coordinator.h"
+#include "memory_report.h"
+#include "benchmarks.h"
 
 #include "courier_new_8.h"
 #include "courier_new_23.h"
@@ -28,6 +33,9 @@ char currentTime[10] = {0};
 char currentTimeNoColumn[10] = {0};
 char currentDate[15] = {0};
 
+// Date sits 17 rows above the bottom edge
+const int DATE_BASELINE = DISPLAY_HEIGHT - 17;
+
 bool justBooted = true;
 bool showCol = false;
 unsigned long prevColTime = 0;
@@ -96,10 +104,10 @@ void displayUpdate() {
 
   display.setFont(&Courier_New_Outside8pt7b);
   display.setTextColor(display.color565(255,255,255));
-  drawCenteredString(currentDate, DISPLAY_WIDTH / 2 + 2, 47 - 4);
+  drawCenteredString(currentDate, DISPLAY_WIDTH / 2 + 2, DATE_BASELINE - 4);
   display.setFont(&Courier_New8pt7b);
   display.setTextColor(display.color565(0,0,0));
-  drawCenteredString(currentDate, DISPLAY_WIDTH / 2, 47);
+  drawCenteredString(currentDate, DISPLAY_WIDTH / 2, DATE_BASELINE);
 
   display.flip();
 }
@@ -117,12 +125,26 @@ void setupWebServer() {
     String json = "{";
     json += "\"currentAnimation\":" + String((int)getCurrentAnimation()) + ",";
     json += "\"inFade\":" + String(isAnimationFading() ? "true" : "false") + ",";
-    json += "\"fadeProgress\":50";  // Simplified for now
+    json += "\"fadeProgress\":" + String(getTransitionProgress()) + ",";
+    json += "\"transition\":" + String((int)getTransitionType()) + ",";
+    json += "\"renderedFrames\":" + String(display.getFlippedFrames()) + ",";
+    json += "\"skippedFrames\":" + String(display.getSkippedFrames()) + ",";
+    json += "\"pushedTiles\":" + String(display.getPushedTiles()) + ",";
+    json += "\"skippedTiles\":" + String(display.getSkippedTiles()) + ",";
+    json += "\"worstFrameUs\":" + String(getWorstFrameTime()) + ",";
+    json += "\"worstTransitionFrameUs\":" + String(getWorstTransitionFrameTime()) + ",";
+    json += "\"dither\":" + String((int)display.getDitherMode()) + ",";
+    json += "\"ditherBits\":" + String(display.getDitherBits());
     json += "}";
     
     request->send(200, "application/json", json);
   });
 
+  // JSON API: Memory budget
+  server.on("/api/memory", HTTP_GET, [](AsyncWebServerRequest* request) {
+    request->send(200, "application/json", memoryReportJson());
+  });
+
   // API: Get available animations list
   server.on("/api/animations", HTTP_GET, [](AsyncWebServerRequest* request) {
     String json = "[";
@@ -130,7 +152,9 @@ void setupWebServer() {
       if (i > 0) json += ",";
       json += "{";
       json += "\"id\":" + String(i) + ",";
-      json += "\"name\":\"" + String(getAnimationName((AnimationType)i)) + "\"";
+      json += "\"name\":\"" + String(getAnimationName((AnimationType)i)) + "\",";
+      json += "\"fps\":" + String(getAnimationDescriptor((AnimationType)i).targetFps) + ",";
+      json += "\"seekable\":" + String(getAnimationDescriptor((AnimationType)i).seekable ? "true" : "false");
       json += "}";
     }
     json += "]";
@@ -155,6 +179,87 @@ void setupWebServer() {
     }
   });
 
+  // API: Get available transitions list
+  server.on("/api/transitions", HTTP_GET, [](AsyncWebServerRequest* request) {
+    String json = "[";
+    for (int i = 0; i < TRANSITION_COUNT; i++) {
+      if (i > 0) json += ",";
+      json += "{";
+      json += "\"id\":" + String(i) + ",";
+      json += "\"name\":\"" + String(Transitions::getName((TransitionType)i)) + "\"";
+      json += "}";
+    }
+    json += "]";
+    
+    request->send(200, "application/json", json);
+  });
+
+  // JSON API: Set transition used for animation switches
+  server.on("/api/transition", HTTP_POST, [](AsyncWebServerRequest* request) {
+    if (request->hasParam("index", true)) {
+      String indexStr = request->getParam("index", true)->value();
+      int transitionIndex = indexStr.toInt();
+  
+      if (transitionIndex >= 0 && transitionIndex < TRANSITION_COUNT) {
+        setTransitionType((TransitionType)transitionIndex);
+        request->send(200, "application/json", "{\"success\":true,\"transition\":" + String(transitionIndex) + "}");
+      } else {
+        request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid transition index\"}");
+      }
+    } else {
+      request->send(400, "application/json", "{\"success\":false,\"error\":\"Missing transition index\"}");
+    }
+  });
+
+  // JSON API: Set output dithering (mode and/or bits per channel)
+  server.on("/api/dither", HTTP_POST, [](AsyncWebServerRequest* request) {
+    int mode = request->hasParam("mode", true) ?
+        request->getParam("mode", true)->value().toInt() : display.getDitherMode();
+    int bits = request->hasParam("bits", true) ?
+        request->getParam("bits", true)->value().toInt() : display.getDitherBits();
+
+    if (mode >= 0 && mode < DITHER_COUNT && bits >= 1 && bits <= 8) {
+      display.setDither((DitherMode)mode, bits);
+      request->send(200, "application/json", "{\"success\":true,\"dither\":\"" + String(Dither::getName((DitherMode)mode)) + "\",\"bits\":" + String(bits) + "}");
+    } else {
+      request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid dither mode or bits\"}");
+    }
+  });
+
+  // JSON API: Tune the fire (any of height, cooling and sparks, 0-255; height in percent)
+  server.on("/api/fire", HTTP_POST, [](AsyncWebServerRequest* request) {
+    FireAnimation::Settings settings = FireAnimation::getSettings();
+    int height = request->hasParam("height", true) ?
+        request->getParam("height", true)->value().toInt() : settings.flameHeight;
+    int cooling = request->hasParam("cooling", true) ?
+        request->getParam("cooling", true)->value().toInt() : settings.cooling;
+    int sparks = request->hasParam("sparks", true) ?
+        request->getParam("sparks", true)->value().toInt() : settings.sparkRate;
+
+    if (height >= 10 && height <= 100 && cooling >= 0 && cooling <= 255 && sparks >= 0 && sparks <= 255) {
+      settings.flameHeight = height;
+      settings.cooling = cooling;
+      settings.sparkRate = sparks;
+      FireAnimation::setSettings(settings);
+      request->send(200, "application/json", "{\"success\":true,\"height\":" + String(height) +
+                    ",\"cooling\":" + String(cooling) + ",\"sparks\":" + String(sparks) + "}");
+    } else {
+      request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid fire settings\"}");
+    }
+  });
+
+  // JSON API: Number of stars drawn by the Stars animation
+  server.on("/api/stars", HTTP_POST, [](AsyncWebServerRequest* request) {
+    int count = request->hasParam("count", true) ? request->getParam("count", true)->value().toInt() : 0;
+
+    if (count >= 1 && count <= StarAnimation::MAX_STARS) {
+      StarAnimation::setStarCount(count);
+      request->send(200, "application/json", "{\"success\":true,\"count\":" + String(count) + "}");
+    } else {
+      request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid star count\"}");
+    }
+  });
+
   server.on("/restart", HTTP_GET, [](AsyncWebServerRequest* request) {
     request->redirect("/");
 
@@ -193,6 +298,7 @@ void setupWebServer() {
 
 void setup() {
   Serial.begin(115200);
+  memoryReportInit();
 
   // Setup wifi
   WiFi.hostname("james_clock_controller_v2");
@@ -223,25 +329,36 @@ void setup() {
 
   // Init the display
   displayInit();
+
+#ifdef CLOCK_BENCHMARKS
+  runBenchmarks();
+#endif
   
   // Initialize animations
   initAnimations();
 
   Serial.println("Display and animations initialized!");
-  Serial.println("Animations will cycle every 3 hours with 2-second fade transitions");
+  memoryReportPrint();
+  Serial.println("Animations will cycle every 3 hours with 2-second transitions");
   Serial.println("Visit the web interface to control animations manually");
 
   delay(3000);
 }
 
 unsigned long lastUpdate = 0;
-const unsigned long FRAME_INTERVAL = 16;  // ~60fps
 void loop() {
-  if (millis() - lastUpdate >= FRAME_INTERVAL) {
+  if (millis() - lastUpdate >= getFrameInterval()) {
+    unsigned long frameStart = micros();
     displayUpdate();
+    recordFrameTime(micros() - frameStart);
     lastUpdate = millis();
+  } else {
+    // Spare time until the next frame goes into warming up the next animation
+    prepareNextAnimation();
   }
 
   ElegantOTA.loop();
   // delay(1);
-}
\ No newline at end of file
+}
+
+#endif // PIO_UNIT_TESTING
@@ -0,0 +1,112 @@
+#include "memory_report.h"
+#include "animations_coordinator.h"
+#include "display.h"
+#include "accumulation.h"
+#include "particles.h"
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+static TaskHandle_t loopTask = nullptr;
+
+struct StaticBuffer {
+    const char* name;
+    size_t bytes;
+};
+
+struct HeapFigures {
+    size_t free;
+    size_t minFree;
+    size_t largestBlock;
+};
+
+static size_t collectStaticBuffers(StaticBuffer* buffers) {
+    size_t count = 0;
+    buffers[count++] = {"frameBuffer", BufferMatrixPanel::FRAME_BYTES};
+    buffers[count++] = {"antialiasBuffer", BufferMatrixPanel::ANTIALIAS_BUFFER_BYTES};
+    return count;
+}
+
+static HeapFigures heapFigures(uint32_t caps) {
+    HeapFigures figures;
+    figures.free = heap_caps_get_free_size(caps);
+    figures.minFree = heap_caps_get_minimum_free_size(caps);
+    figures.largestBlock = heap_caps_get_largest_free_block(caps);
+    return figures;
+}
+
+// Unused stack in bytes, or -1 if the task doesn't exist
+static long stackHeadroom(TaskHandle_t task) {
+    // ESP-IDF's FreeRTOS reports stack depth in bytes rather than words
+    return task ? (long)uxTaskGetStackHighWaterMark(task) : -1;
+}
+
+static String heapJson(const HeapFigures& figures) {
+    String json = "{";
+    json += "\"free\":" + String((unsigned long)figures.free) + ",";
+    json += "\"minFree\":" + String((unsigned long)figures.minFree) + ",";
+    json += "\"largestBlock\":" + String((unsigned long)figures.largestBlock);
+    json += "}";
+    return json;
+}
+
+void memoryReportInit() {
+    loopTask = xTaskGetCurrentTaskHandle();
+}
+
+String memoryReportJson() {
+    StaticBuffer buffers[4];
+    size_t count = collectStaticBuffers(buffers);
+
+    String json = "{";
+
+    json += "\"static\":{";
+    for (size_t i = 0; i < count; i++) {
+        json += "\"" + String(buffers[i].name) + "\":" + String((unsigned long)buffers[i].bytes) + ",";
+    }
+    json += "\"animationStatesUnshared\":" + String((unsigned long)getAnimationStateTotalSize());
+    json += "},";
+
+    json += "\"heap\":{";
+    json += "\"internal\":" + heapJson(heapFigures(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)) + ",";
+    json += "\"dma\":" + heapJson(heapFigures(MALLOC_CAP_DMA)) + ",";
+    json += "\"animationStateArena\":" + String((unsigned long)getAnimationStateArenaSize()) + ",";
+    json += "\"transitionBuffer\":" + String((unsigned long)getTransitionBufferSize()) + ",";
+    json += "\"accumulationBuffers\":" + String((unsigned long)Accumulation::getAllocatedSize()) + ",";
+    json += "\"particlePools\":" + String((unsigned long)Particles::getAllocatedSize());
+    json += "},";
+
+    json += "\"stackHeadroom\":{";
+    json += "\"loop\":" + String(stackHeadroom(loopTask)) + ",";
+    json += "\"asyncTcp\":" + String(stackHeadroom(xTaskGetHandle("async_tcp")));
+    json += "}";
+
+    json += "}";
+    return json;
+}
+
+void memoryReportPrint() {
+    StaticBuffer buffers[4];
+    size_t count = collectStaticBuffers(buffers);
+
+    Serial.println("Static buffers:");
+    for (size_t i = 0; i < count; i++) {
+        Serial.printf("  %-20s %6u bytes\n", buffers[i].name, (unsigned)buffers[i].bytes);
+    }
+    // Between switches the arena is one slot of the largest State budget; a
+    // second is only held while the next animation warms up or fades in
+    size_t slot = getAnimationStateSlotSize();
+    size_t unshared = getAnimationStateTotalSize();
+    Serial.printf("Animation state arena: %u byte slot, %u bytes %s than the states as separate statics (%u)\n",
+                  (unsigned)slot, (unsigned)(slot > unshared ? slot - unshared : unshared - slot),
+                  slot > unshared ? "more" : "less", (unsigned)unshared);
+
+    HeapFigures internal = heapFigures(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    HeapFigures dma = heapFigures(MALLOC_CAP_DMA);
+    Serial.printf("Internal heap: %u free, %u min free, %u largest block\n",
+                  (unsigned)internal.free, (unsigned)internal.minFree, (unsigned)internal.largestBlock);
+    Serial.printf("DMA heap: %u free, %u min free, %u largest block\n",
+                  (unsigned)dma.free, (unsigned)dma.minFree, (unsigned)dma.largestBlock);
+    Serial.printf("Stack headroom: loop %ld, async_tcp %ld bytes\n",
+                  stackHeadroom(loopTask), stackHeadroom(xTaskGetHandle("async_tcp")));
+}
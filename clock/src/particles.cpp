@@ -0,0 +1,140 @@
+#include "particles.h"
+#include "accumulation.h"
+#include "animation_utils.h"
+#include "hot_path.h"
+
+namespace Particles {
+    static size_t allocatedSize = 0;
+    
+    // Coverage of a particle's dot, centred on the particle
+    static const uint8_t DOT[DOT_SIZE][DOT_SIZE] = {
+        {  0,  64, 112,  64,   0},
+        { 64, 192, 255, 192,  64},
+        {112, 255, 255, 255, 112},
+        { 64, 192, 255, 192,  64},
+        {  0,  64, 112,  64,   0}
+    };
+    
+    // Particles fade out over this many frames before they expire
+    static const uint8_t FADE_FRAMES = 32;
+    
+    // Bytes per particle over all fields
+    static const size_t PARTICLE_BYTES = 5 * sizeof(int16_t) + sizeof(uint8_t);
+    
+    bool allocate(Pool& pool, uint16_t capacity) {
+        release(pool);
+        
+        // One block for every field; the 16-bit fields come first to keep
+        // them aligned
+        uint8_t* block = (uint8_t*)malloc(capacity * PARTICLE_BYTES);
+        if (!block) return false;
+        
+        pool.x = (int16_t*)block;
+        pool.y = pool.x + capacity;
+        pool.vx = pool.y + capacity;
+        pool.vy = pool.vx + capacity;
+        pool.color = (uint16_t*)(pool.vy + capacity);
+        pool.life = (uint8_t*)(pool.color + capacity);
+        pool.capacity = capacity;
+        pool.count = 0;
+        allocatedSize += capacity * PARTICLE_BYTES;
+        return true;
+    }
+    
+    void release(Pool& pool) {
+        if (pool.x) {
+            free(pool.x);
+            allocatedSize -= pool.capacity * PARTICLE_BYTES;
+        }
+        pool = Pool();
+    }
+    
+    size_t getAllocatedSize() {
+        return allocatedSize;
+    }
+    
+    void emit(Pool& pool, Emitter& emitter) {
+        uint32_t owed = emitter.owed + emitter.rate;
+        for (; owed >= 256; owed -= 256) {
+            int16_t vx = emitter.vx, vy = emitter.vy;
+            if (emitter.spread) {
+                vx += random(-emitter.spread, emitter.spread + 1);
+                vy += random(-emitter.spread, emitter.spread + 1);
+            }
+            if (!spawn(pool, emitter.x, emitter.y, vx, vy, emitter.life, emitter.color)) {
+                owed = 0;
+                break;
+            }
+        }
+        emitter.owed = owed;
+    }
+    
+    void CLOCK_HOT_PATH update(Pool& pool, int16_t gravity) {
+        const int16_t minX = -(DOT_SIZE << POSITION_SHIFT);
+        const int16_t minY = -(DOT_SIZE << POSITION_SHIFT);
+        const int16_t maxX = (DISPLAY_WIDTH + DOT_SIZE) << POSITION_SHIFT;
+        const int16_t maxY = (DISPLAY_HEIGHT + DOT_SIZE) << POSITION_SHIFT;
+        
+        uint16_t i = 0;
+        while (i < pool.count) {
+            int16_t x = pool.x[i] + pool.vx[i];
+            int16_t y = pool.y[i] + pool.vy[i];
+            uint8_t life = pool.life[i] - 1;
+            
+            if (life == 0 || x < minX || x > maxX || y < minY || y > maxY) {
+                // The last particle moves in here and is updated next
+                kill(pool, i);
+                continue;
+            }
+            
+            pool.x[i] = x;
+            pool.y[i] = y;
+            pool.vy[i] += gravity;
+            pool.life[i] = life;
+            i++;
+        }
+    }
+    
+    // Blends one dot with its top left at (left, top) at up to alpha/256
+    static inline void drawDot(uint32_t* accumulation, int left, int top, uint16_t color, uint16_t alpha) {
+        int i0 = left < 0 ? -left : 0;
+        int j0 = top < 0 ? -top : 0;
+        int i1 = left + DOT_SIZE > DISPLAY_WIDTH ? DISPLAY_WIDTH - left : DOT_SIZE;
+        int j1 = top + DOT_SIZE > DISPLAY_HEIGHT ? DISPLAY_HEIGHT - top : DOT_SIZE;
+        
+        if (!accumulation) {
+            for (int j = j0; j < j1; j++) {
+                for (int i = i0; i < i1; i++) {
+                    uint8_t coverage = (DOT[j][i] * alpha) >> 8;
+                    if (coverage) {
+                        AnimationUtils::drawPixelWithBlend(left + i, top + j, color, coverage);
+                    }
+                }
+            }
+            return;
+        }
+        
+        uint32_t packed = Accumulation::from565(color);
+        for (int j = j0; j < j1; j++) {
+            uint32_t* row = accumulation + (top + j) * DISPLAY_WIDTH + left;
+            for (int i = i0; i < i1; i++) {
+                uint16_t coverage = (DOT[j][i] * alpha) >> 8;
+                if (coverage) {
+                    row[i] = Accumulation::blend(row[i], packed, coverage + (coverage >> 7));
+                }
+            }
+        }
+    }
+    
+    void CLOCK_HOT_PATH draw(const Pool& pool, uint32_t* accumulation) {
+        const int half = DOT_SIZE / 2;
+        for (uint16_t i = 0; i < pool.count; i++) {
+            // Round to the nearest pixel
+            int x = (pool.x[i] + (1 << (POSITION_SHIFT - 1))) >> POSITION_SHIFT;
+            int y = (pool.y[i] + (1 << (POSITION_SHIFT - 1))) >> POSITION_SHIFT;
+            uint8_t life = pool.life[i];
+            uint16_t alpha = life >= FADE_FRAMES ? 256 : life * (256 / FADE_FRAMES);
+            drawDot(accumulation, x - half, y - half, pool.color[i], alpha);
+        }
+    }
+}
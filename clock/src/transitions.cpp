@@ -0,0 +1,84 @@
+#include "transitions.h"
+#include "display_config.h"
+#include "hot_path.h"
+#include "dither.h"
+#include "packed565.h"
+
+namespace Transitions {
+    static void CLOCK_HOT_PATH crossfade(uint16_t* out, const uint16_t* outgoing, const uint16_t* incoming, uint16_t progress) {
+        uint32_t weight = progress >> 3; // 0-32
+        for (int i = 0; i < DISPLAY_WIDTH * DISPLAY_HEIGHT; i++) {
+            out[i] = Packed565::blend(outgoing[i], incoming[i], weight);
+        }
+    }
+
+    static void wipe(uint16_t* out, const uint16_t* outgoing, const uint16_t* incoming, uint16_t progress) {
+        // Incoming animation sweeps in from the left
+        int edge = (DISPLAY_WIDTH * progress) / PROGRESS_MAX;
+        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+            int row = y * DISPLAY_WIDTH;
+            memcpy(out + row, incoming + row, edge * sizeof(uint16_t));
+            memcpy(out + row + edge, outgoing + row + edge, (DISPLAY_WIDTH - edge) * sizeof(uint16_t));
+        }
+    }
+
+    static void CLOCK_HOT_PATH dissolve(uint16_t* out, const uint16_t* outgoing, const uint16_t* incoming, uint16_t progress) {
+        // A pixel switches over once progress passes its ordered-dither threshold
+        uint8_t level = (progress * 64) / PROGRESS_MAX;
+        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+            const uint8_t* thresholds = Dither::BAYER_8X8[y & 7];
+            int row = y * DISPLAY_WIDTH;
+            for (int x = 0; x < DISPLAY_WIDTH; x++) {
+                out[row + x] = thresholds[x & 7] < level ? incoming[row + x] : outgoing[row + x];
+            }
+        }
+    }
+
+    static void slide(uint16_t* out, const uint16_t* outgoing, const uint16_t* incoming, uint16_t progress) {
+        // Incoming animation pushes the outgoing one out to the left
+        int offset = (DISPLAY_WIDTH * progress) / PROGRESS_MAX;
+        int kept = DISPLAY_WIDTH - offset;
+        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+            int row = y * DISPLAY_WIDTH;
+            memcpy(out + row, outgoing + row + offset, kept * sizeof(uint16_t));
+            memcpy(out + row + kept, incoming + row, offset * sizeof(uint16_t));
+        }
+    }
+
+    void blend(TransitionType type, uint16_t* out, const uint16_t* outgoing, const uint16_t* incoming, uint16_t progress) {
+        if (progress > PROGRESS_MAX) {
+            progress = PROGRESS_MAX;
+        }
+
+        switch(type) {
+            case TRANSITION_WIPE:
+                wipe(out, outgoing, incoming, progress);
+                break;
+            case TRANSITION_DISSOLVE:
+                dissolve(out, outgoing, incoming, progress);
+                break;
+            case TRANSITION_SLIDE:
+                slide(out, outgoing, incoming, progress);
+                break;
+            case TRANSITION_CROSSFADE:
+            default:
+                crossfade(out, outgoing, incoming, progress);
+                break;
+        }
+    }
+
+    const char* getName(TransitionType type) {
+        switch(type) {
+            case TRANSITION_CROSSFADE:
+                return "Crossfade";
+            case TRANSITION_WIPE:
+                return "Wipe";
+            case TRANSITION_DISSOLVE:
+                return "Dissolve";
+            case TRANSITION_SLIDE:
+                return "Slide";
+            default:
+                return "Unknown";
+        }
+    }
+}
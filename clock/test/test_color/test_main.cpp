@@ -0,0 +1,125 @@
+// The integer colour paths against the arithmetic they replace: fixed-point
+// HSL against the float hslToRgb(), and the packed RGB565 kernels against
+// the same maths done one channel at a time. Runs on the board:
+//
+//   pio test -e esp32doit-devkit-v1 -f test_color
+
+#include <Arduino.h>
+#include <unity.h>
+#include "animation_utils.h"
+#include "packed565.h"
+
+void setUp() {}
+
+void tearDown() {}
+
+static int channelDiff(uint16_t a, uint16_t b) {
+    int dr = abs((a >> 11) - (b >> 11));
+    int dg = abs(((a >> 5) & 0x3F) - ((b >> 5) & 0x3F));
+    int db = abs((a & 0x1F) - (b & 0x1F));
+    return max(dr, max(dg, db));
+}
+
+// Small xorshift, so every run (and the board) sees the same samples
+static uint32_t randomState = 2463534242u;
+
+static uint32_t nextRandom() {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+static void test_fixed_hsl_within_one_of_float() {
+    for (uint32_t h = 0; h < 65536; h += 97) {
+        for (int s = 0; s < 256; s += 15) {
+            for (int l = 0; l < 256; l += 15) {
+                uint8_t r, g, b, fr, fg, fb;
+                AnimationUtils::hslToRgbFixed(h, s, l, &r, &g, &b);
+                AnimationUtils::hslToRgb(h / 65536.0f, s / 255.0f, l / 255.0f, &fr, &fg, &fb);
+                TEST_ASSERT_INT_WITHIN(1, fr, r);
+                TEST_ASSERT_INT_WITHIN(1, fg, g);
+                TEST_ASSERT_INT_WITHIN(1, fb, b);
+            }
+        }
+    }
+}
+
+// Both RGB565 paths land within one step of the float colour
+static void test_hsl565_and_batch_within_one_step_of_float() {
+    HSL colors[64];
+    uint16_t batch[64];
+    for (int round = 0; round < 256; round++) {
+        for (int i = 0; i < 64; i++) {
+            uint32_t bits = nextRandom();
+            colors[i].h = bits;
+            colors[i].s = bits >> 16;
+            colors[i].l = bits >> 24;
+        }
+        AnimationUtils::hslTo565Batch(colors, batch, 64);
+
+        for (int i = 0; i < 64; i++) {
+            uint8_t r, g, b;
+            AnimationUtils::hslToRgb(colors[i].h / 65536.0f, colors[i].s / 255.0f, colors[i].l / 255.0f, &r, &g, &b);
+            uint16_t single = AnimationUtils::hslTo565(colors[i].h, colors[i].s, colors[i].l);
+            TEST_ASSERT_EQUAL_HEX16(single, batch[i]);
+            TEST_ASSERT_LESS_OR_EQUAL(1, channelDiff(AnimationUtils::rgb888To565(r, g, b), single));
+        }
+    }
+}
+
+static uint16_t addReference(uint16_t a, uint16_t b) {
+    int r = min((a >> 11) + (b >> 11), 31);
+    int g = min(((a >> 5) & 0x3F) + ((b >> 5) & 0x3F), 63);
+    int bl = min((a & 0x1F) + (b & 0x1F), 31);
+    return (r << 11) | (g << 5) | bl;
+}
+
+// Every pair of values of each channel, with the other two channels random,
+// then random colours
+static void test_add_saturate_matches_per_channel() {
+    const int SHIFTS[3] = {11, 5, 0};
+    const int LEVELS[3] = {32, 64, 32};
+    for (int c = 0; c < 3; c++) {
+        uint16_t others = ~((LEVELS[c] - 1) << SHIFTS[c]);
+        for (int x = 0; x < LEVELS[c]; x++) {
+            for (int y = 0; y < LEVELS[c]; y++) {
+                uint16_t a = (nextRandom() & others) | (x << SHIFTS[c]);
+                uint16_t b = (nextRandom() & others) | (y << SHIFTS[c]);
+                TEST_ASSERT_EQUAL_HEX16(addReference(a, b), AnimationUtils::addSaturate565(a, b));
+            }
+        }
+    }
+    for (int i = 0; i < 100000; i++) {
+        uint32_t bits = nextRandom();
+        TEST_ASSERT_EQUAL_HEX16(addReference(bits, bits >> 16), AnimationUtils::addSaturate565(bits, bits >> 16));
+    }
+}
+
+// mix() works on all three channels at once, letting negative differences
+// borrow into the spare bits; per channel it is (s * w + d * (32 - w)) / 32
+// rounded down
+static void test_packed_blend_matches_per_channel() {
+    for (int i = 0; i < 100000; i++) {
+        uint32_t bits = nextRandom();
+        uint16_t dst = bits, src = bits >> 16;
+        uint32_t weight = nextRandom() % 33;
+
+        int r = ((src >> 11) * weight + (dst >> 11) * (32 - weight)) >> 5;
+        int g = (((src >> 5) & 0x3F) * weight + ((dst >> 5) & 0x3F) * (32 - weight)) >> 5;
+        int b = ((src & 0x1F) * weight + (dst & 0x1F) * (32 - weight)) >> 5;
+        TEST_ASSERT_EQUAL_HEX16((r << 11) | (g << 5) | b, Packed565::blend(dst, src, weight));
+    }
+}
+
+void setup() {
+    delay(2000); // Give the serial monitor time to attach
+    UNITY_BEGIN();
+    RUN_TEST(test_fixed_hsl_within_one_of_float);
+    RUN_TEST(test_hsl565_and_batch_within_one_step_of_float);
+    RUN_TEST(test_add_saturate_matches_per_channel);
+    RUN_TEST(test_packed_blend_matches_per_channel);
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,85 @@
+// flip() gamma corrects before it dithers, and the dither only moves the
+// correction's rounding between neighbouring pixels and frames: averaged
+// over the 8x8 pattern (and the 4 frames of temporal dithering) every
+// level comes out where the 16-bit curve puts it. Runs on the board:
+//
+//   pio test -e esp32doit-devkit-v1 -f test_dither
+
+#include <Arduino.h>
+#include <unity.h>
+#include "dither.h"
+
+void setUp() {}
+
+void tearDown() {}
+
+static void test_gamma_tables_are_monotonic_and_full_range() {
+    TEST_ASSERT_EQUAL_UINT16(0, Dither::GAMMA_5[0]);
+    TEST_ASSERT_EQUAL_UINT16(65535, Dither::GAMMA_5[31]);
+    TEST_ASSERT_EQUAL_UINT16(0, Dither::GAMMA_6[0]);
+    TEST_ASSERT_EQUAL_UINT16(65535, Dither::GAMMA_6[63]);
+    for (int i = 1; i < 32; i++) {
+        TEST_ASSERT_TRUE(Dither::GAMMA_5[i] > Dither::GAMMA_5[i - 1]);
+    }
+    for (int i = 1; i < 64; i++) {
+        TEST_ASSERT_TRUE(Dither::GAMMA_6[i] > Dither::GAMMA_6[i - 1]);
+    }
+}
+
+// Mean output, in 16-bit terms, of `value` over the dither pattern and
+// `frames` frames at `bits` bits per channel
+static float meanOutput(DitherMode mode, uint8_t bits, uint16_t value, int frames) {
+    uint8_t mask = 0xFF << (8 - bits);
+    uint16_t offsets[8];
+    uint32_t total = 0;
+    for (int frame = 0; frame < frames; frame++) {
+        for (int y = 0; y < 8; y++) {
+            Dither::rowOffsets(mode, bits, y, frame, offsets);
+            for (int x = 0; x < 8; x++) {
+                total += Dither::apply(value, offsets[x], mask) << 8;
+            }
+        }
+    }
+    return total / (64.0f * frames);
+}
+
+// Every corrected level below the top output level, at every depth
+static void checkMeans(DitherMode mode, int frames) {
+    for (uint8_t bits = 3; bits <= 8; bits++) {
+        uint32_t step = 1UL << (16 - bits);
+        uint32_t top = (uint32_t)(0xFF & (0xFF << (8 - bits))) << 8;
+        for (int i = 0; i < 64; i++) {
+            uint16_t value = Dither::GAMMA_6[i];
+            if (value > top) continue;
+            TEST_ASSERT_FLOAT_WITHIN(step / 64.0f + 1, value, meanOutput(mode, bits, value, frames));
+        }
+    }
+}
+
+static void test_ordered_dither_averages_to_the_corrected_level() {
+    checkMeans(DITHER_ORDERED, 1);
+}
+
+static void test_temporal_dither_averages_to_the_corrected_level() {
+    checkMeans(DITHER_TEMPORAL, 4);
+}
+
+static void test_no_dither_truncates_the_corrected_level() {
+    uint16_t offsets[8];
+    Dither::rowOffsets(DITHER_NONE, 5, 0, 0, offsets);
+    for (int i = 0; i < 32; i++) {
+        TEST_ASSERT_EQUAL_UINT16((Dither::GAMMA_5[i] >> 8) & 0xF8, Dither::apply(Dither::GAMMA_5[i], offsets[i & 7], 0xF8));
+    }
+}
+
+void setup() {
+    delay(2000); // Give the serial monitor time to attach
+    UNITY_BEGIN();
+    RUN_TEST(test_gamma_tables_are_monotonic_and_full_range);
+    RUN_TEST(test_ordered_dither_averages_to_the_corrected_level);
+    RUN_TEST(test_temporal_dither_averages_to_the_corrected_level);
+    RUN_TEST(test_no_dither_truncates_the_corrected_level);
+    UNITY_END();
+}
+
+void loop() {}
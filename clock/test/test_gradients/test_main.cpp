@@ -0,0 +1,105 @@
+// Gradient baking in each colour space and easing, and the LUT span fills
+// that draw baked gradients. Runs on the board:
+//
+//   pio test -e esp32doit-devkit-v1 -f test_gradients
+
+#include <Arduino.h>
+#include <unity.h>
+#include "animation_utils.h"
+
+static const int SIZE = 64;
+
+static const GradientStop RED_TO_BLUE[] = {
+    {0, 255, 0, 0},
+    {255, 0, 0, 255}
+};
+
+static uint16_t linear[SIZE];
+static uint16_t eased[SIZE];
+
+void setUp() {
+    display.clearData();
+}
+
+void tearDown() {}
+
+static void test_ends_are_the_stops() {
+    AnimationUtils::bakeGradient(RED_TO_BLUE, 2, linear, SIZE);
+    AnimationUtils::bakeGradient(RED_TO_BLUE, 2, eased, SIZE, GRADIENT_RGB, GRADIENT_EASE_IN_OUT);
+    TEST_ASSERT_EQUAL_HEX16(0xF800, linear[0]);
+    TEST_ASSERT_EQUAL_HEX16(0xF800, eased[0]);
+
+    // The last entry is (SIZE - 1)/SIZE of the way along, one step short of
+    // the end stop
+    TEST_ASSERT_LESS_OR_EQUAL(1, linear[SIZE - 1] >> 11);
+    TEST_ASSERT_GREATER_OR_EQUAL(30, linear[SIZE - 1] & 0x1F);
+    TEST_ASSERT_LESS_OR_EQUAL(1, eased[SIZE - 1] >> 11);
+}
+
+// Smoothstep leaves the start slower, passes the middle at the same colour
+// and arrives later than the straight line
+static void test_ease_in_out_is_smoothstep() {
+    AnimationUtils::bakeGradient(RED_TO_BLUE, 2, linear, SIZE);
+    AnimationUtils::bakeGradient(RED_TO_BLUE, 2, eased, SIZE, GRADIENT_RGB, GRADIENT_EASE_IN_OUT);
+    for (int i = 1; i < SIZE / 2; i++) {
+        TEST_ASSERT_GREATER_OR_EQUAL(linear[i] >> 11, eased[i] >> 11);
+        TEST_ASSERT_LESS_OR_EQUAL(linear[i] & 0x1F, eased[i] & 0x1F);
+    }
+    TEST_ASSERT_INT_WITHIN(1, linear[SIZE / 2] >> 11, eased[SIZE / 2] >> 11);
+    for (int i = SIZE / 2 + 1; i < SIZE; i++) {
+        TEST_ASSERT_LESS_OR_EQUAL(linear[i] >> 11, eased[i] >> 11);
+        TEST_ASSERT_GREATER_OR_EQUAL(linear[i] & 0x1F, eased[i] & 0x1F);
+    }
+}
+
+// HSL stops are interpolated as hue, saturation and lightness, so a red to
+// blue gradient goes round through green rather than through purple
+static void test_hsl_interpolates_hue() {
+    static const GradientStop HUES[] = {
+        {0, 0, 255, 128},
+        {255, 170, 255, 128}
+    };
+    AnimationUtils::bakeGradient(HUES, 2, linear, SIZE, GRADIENT_HSL);
+
+    for (int i = 0; i < SIZE; i++) {
+        // Fraction along in 1/256ths, as bakeGradient works it out
+        uint32_t t = (((uint32_t)i * 255 << 8) / SIZE << 8) / (255 << 8);
+        uint8_t hue = (170 * t) >> 8;
+        uint8_t r, g, b;
+        AnimationUtils::hslToRgb(hue / 255.0f, 1.0f, 128 / 255.0f, &r, &g, &b);
+        TEST_ASSERT_EQUAL_HEX16(AnimationUtils::rgb888To565(r, g, b), linear[i]);
+    }
+
+    // A third of a turn in is pure green
+    TEST_ASSERT_EQUAL_HEX16(0x07E0, linear[SIZE / 2] & 0x07E0);
+    TEST_ASSERT_LESS_OR_EQUAL(2, linear[SIZE / 2] >> 11);
+}
+
+static void test_fill_columns_from_lut() {
+    for (int i = 0; i < SIZE; i++) {
+        linear[i] = 0x1000 + i;
+    }
+
+    // Starts off the left edge, so the LUT is entered part way through
+    AnimationUtils::fillColumnsFromLut(-4, 20, 3, 9, linear);
+
+    const uint16_t* frame = display.getRenderTarget();
+    for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+        for (int x = 0; x < DISPLAY_WIDTH; x++) {
+            bool inside = x < 20 && y >= 3 && y < 9;
+            TEST_ASSERT_EQUAL_HEX16(inside ? linear[x + 4] : 0, frame[y * DISPLAY_WIDTH + x]);
+        }
+    }
+}
+
+void setup() {
+    delay(2000); // Give the serial monitor time to attach
+    UNITY_BEGIN();
+    RUN_TEST(test_ends_are_the_stops);
+    RUN_TEST(test_ease_in_out_is_smoothstep);
+    RUN_TEST(test_hsl_interpolates_hue);
+    RUN_TEST(test_fill_columns_from_lut);
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,87 @@
+// Particle lifetimes: a particle spawned with `life` frames is drawn for
+// exactly that many updates, the pool refuses particles with none, and
+// killing one keeps the others where they were. Runs on the board:
+//
+//   pio test -e esp32doit-devkit-v1 -f test_particles
+
+#include <Arduino.h>
+#include <unity.h>
+#include "particles.h"
+
+static Particles::Pool pool;
+
+void setUp() {
+    TEST_ASSERT_TRUE(Particles::allocate(pool, 8));
+}
+
+void tearDown() {
+    Particles::release(pool);
+}
+
+// Updates until the pool is empty, at most 300 times
+static int updatesUntilEmpty() {
+    int updates = 0;
+    while (pool.count && updates < 300) {
+        Particles::update(pool);
+        updates++;
+    }
+    return updates;
+}
+
+// Zero life used to wrap to 255 frames, the longest a particle can live
+static void test_spawn_rejects_zero_life() {
+    TEST_ASSERT_FALSE(Particles::spawn(pool, 0, 0, 0, 0, 0, 0xFFFF));
+    TEST_ASSERT_EQUAL(0, pool.count);
+}
+
+static void test_particle_lives_its_frames() {
+    const uint8_t LIVES[] = {1, 2, 32, 255};
+    for (uint8_t life : LIVES) {
+        TEST_ASSERT_TRUE(Particles::spawn(pool, Particles::toFixed(10), Particles::toFixed(10), 0, 0, life, 0xFFFF));
+        TEST_ASSERT_EQUAL(life, updatesUntilEmpty());
+    }
+}
+
+static void test_emitter_with_zero_life_spawns_nothing() {
+    Particles::Emitter emitter;
+    emitter.rate = 4 * 256;
+    emitter.life = 0;
+    Particles::emit(pool, emitter);
+    TEST_ASSERT_EQUAL(0, pool.count);
+}
+
+static void test_spawn_stops_at_capacity() {
+    for (int i = 0; i < pool.capacity; i++) {
+        TEST_ASSERT_TRUE(Particles::spawn(pool, 0, 0, 0, 0, 10, 0xFFFF));
+    }
+    TEST_ASSERT_FALSE(Particles::spawn(pool, 0, 0, 0, 0, 10, 0xFFFF));
+    TEST_ASSERT_EQUAL(pool.capacity, pool.count);
+}
+
+// The short-lived particle in the middle expires and the last one moves
+// into its place unchanged
+static void test_expired_particle_is_replaced_by_the_last() {
+    Particles::spawn(pool, Particles::toFixed(1), 0, 0, 0, 50, 0x0001);
+    Particles::spawn(pool, Particles::toFixed(2), 0, 0, 0, 1, 0x0002);
+    Particles::spawn(pool, Particles::toFixed(3), 0, 0, 0, 50, 0x0003);
+    Particles::update(pool);
+
+    TEST_ASSERT_EQUAL(2, pool.count);
+    TEST_ASSERT_EQUAL_HEX16(0x0001, pool.color[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0003, pool.color[1]);
+    TEST_ASSERT_EQUAL(Particles::toFixed(3), pool.x[1]);
+    TEST_ASSERT_EQUAL(49, pool.life[1]);
+}
+
+void setup() {
+    delay(2000); // Give the serial monitor time to attach
+    UNITY_BEGIN();
+    RUN_TEST(test_spawn_rejects_zero_life);
+    RUN_TEST(test_particle_lives_its_frames);
+    RUN_TEST(test_emitter_with_zero_life_spawns_nothing);
+    RUN_TEST(test_spawn_stops_at_capacity);
+    RUN_TEST(test_expired_particle_is_replaced_by_the_last);
+    UNITY_END();
+}
+
+void loop() {}
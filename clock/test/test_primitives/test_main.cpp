@@ -0,0 +1,191 @@
+// The integer and span primitives against the exact geometry they stand in
+// for: ellipse spans against a per-pixel test, circle edges and line
+// coverage against analytic distances and areas. Shapes are drawn in white
+// on black, so a pixel's green channel is its coverage; lines are drawn
+// into an accumulation buffer to keep 8 bits of it. Runs on the board:
+//
+//   pio test -e esp32doit-devkit-v1 -f test_primitives
+
+#include <Arduino.h>
+#include <unity.h>
+#include "animation_utils.h"
+#include "accumulation.h"
+
+void setUp() {
+    display.clearData();
+}
+
+void tearDown() {}
+
+static uint32_t accumulation[DISPLAY_WIDTH * DISPLAY_HEIGHT];
+
+static float coverageAt(int x, int y) {
+    return ((display.getRenderTarget()[y * DISPLAY_WIDTH + x] >> 5) & 0x3F) / 63.0f;
+}
+
+// White is 0xFC in the accumulation buffer's green channel
+static float accumulatedAt(int x, int y) {
+    return ((accumulation[y * DISPLAY_WIDTH + x] >> 8) & 0xFF) / (float)((Accumulation::from565(0xFFFF) >> 8) & 0xFF);
+}
+
+static void beginLine() {
+    memset(accumulation, 0, sizeof(accumulation));
+    AnimationUtils::beginAccumulation(accumulation);
+}
+
+static float clamp01(float value) {
+    return value < 0 ? 0 : (value > 1 ? 1 : value);
+}
+
+// Beach's sea and wet sand: an ellipse twice the display wide, centred on
+// it, at every height up to the display's, against the per-pixel test the
+// spans replaced
+static void test_ellipse_spans_match_per_pixel_test() {
+    float centerX = DISPLAY_WIDTH / 2.0f;
+    float halfWidth = DISPLAY_WIDTH;
+    for (int height = 1; height <= DISPLAY_HEIGHT; height++) {
+        float centerY = height / 2.0f;
+        for (int y = 0; y < height; y++) {
+            float dy = (y - centerY) / (height / 2.0f);
+            int x0 = 0, x1 = 0;
+            bool any = AnimationUtils::ellipseSpan(centerX, halfWidth, dy, &x0, &x1);
+
+            int expected0 = DISPLAY_WIDTH, expected1 = 0;
+            for (int x = 0; x < DISPLAY_WIDTH; x++) {
+                float dx = (x - centerX) / halfWidth;
+                if (dx * dx + dy * dy <= 1.0f) {
+                    expected0 = min(expected0, x);
+                    expected1 = x + 1;
+                }
+            }
+            TEST_ASSERT_EQUAL(expected0 < expected1, any);
+            if (any) {
+                TEST_ASSERT_EQUAL(expected0, x0);
+                TEST_ASSERT_EQUAL(expected1, x1);
+            }
+        }
+    }
+}
+
+// Coverage tables are 16 steps over a pixel and the blend has 5-bit
+// weights, so allow a table step plus a weight step and the 6-bit channel
+static const float CIRCLE_TOLERANCE = 1 / 16.0f + 1 / 32.0f + 1 / 63.0f;
+
+static void test_fill_circle_edges_follow_the_distance() {
+    const int cx = DISPLAY_WIDTH / 2, cy = DISPLAY_HEIGHT / 2;
+    for (int radius = 4; radius < DISPLAY_HEIGHT / 2; radius++) {
+        display.clearData();
+        AnimationUtils::fillCircle(cx, cy, radius, 0xFFFF);
+        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+            for (int x = 0; x < DISPLAY_WIDTH; x++) {
+                float distance = sqrtf((x - cx) * (x - cx) + (y - cy) * (y - cy)) - radius;
+                TEST_ASSERT_FLOAT_WITHIN(CIRCLE_TOLERANCE, clamp01(0.5f - distance), coverageAt(x, y));
+            }
+        }
+    }
+}
+
+static void test_circle_ring_follows_the_distance() {
+    const int cx = DISPLAY_WIDTH / 2, cy = DISPLAY_HEIGHT / 2;
+    for (int radius = 4; radius < DISPLAY_HEIGHT / 2; radius++) {
+        display.clearData();
+        AnimationUtils::drawCircle(cx, cy, radius, 0xFFFF);
+        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+            for (int x = 0; x < DISPLAY_WIDTH; x++) {
+                float distance = sqrtf((x - cx) * (x - cx) + (y - cy) * (y - cy)) - radius;
+                TEST_ASSERT_FLOAT_WITHIN(CIRCLE_TOLERANCE, clamp01(1 - fabsf(distance)), coverageAt(x, y));
+            }
+        }
+    }
+}
+
+static uint32_t randomState = 88172645u;
+
+static int randomIn(int low, int high) {
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return low + (int)(randomState % (uint32_t)(high - low));
+}
+
+// A Wu line splits one pixel of coverage across the minor axis at every
+// step along the major one, so every on-screen column (or row) of a line
+// sums to a whole pixel. Lines may start and end off the display.
+static void test_wu_line_columns_sum_to_one_pixel() {
+    for (int i = 0; i < 500; i++) {
+        int x0 = randomIn(-32, DISPLAY_WIDTH + 32), y0 = randomIn(-16, DISPLAY_HEIGHT + 16);
+        int x1 = randomIn(-32, DISPLAY_WIDTH + 32), y1 = randomIn(-16, DISPLAY_HEIGHT + 16);
+        bool steep = abs(y1 - y0) > abs(x1 - x0);
+        beginLine();
+        AnimationUtils::drawLine(x0, y0, x1, y1, 0xFFFF);
+        AnimationUtils::resolveAccumulation();
+
+        int major0 = steep ? min(y0, y1) : min(x0, x1);
+        int major1 = steep ? max(y0, y1) : max(x0, x1);
+        int majorSize = steep ? DISPLAY_HEIGHT : DISPLAY_WIDTH;
+        int minorSize = steep ? DISPLAY_WIDTH : DISPLAY_HEIGHT;
+        for (int m = max(0, major0); m <= min(majorSize - 1, major1); m++) {
+            // Where the line is within a pixel of the minor edges part of
+            // its coverage falls off the display
+            float minor = steep ? x0 + (float)(x1 - x0) * (m - y0) / (y1 - y0)
+                                : y0 + (float)(y1 - y0) * (m - x0) / (x1 - x0);
+            if (minor < 1 || minor > minorSize - 2) continue;
+
+            float sum = 0;
+            for (int n = 0; n < minorSize; n++) {
+                sum += steep ? accumulatedAt(n, m) : accumulatedAt(m, n);
+            }
+            TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, sum);
+        }
+    }
+}
+
+// A wide line is the quad around the segment, so its coverage adds up to
+// its length times its width
+static void test_wide_line_covers_its_area() {
+    for (int i = 0; i < 200; i++) {
+        int x0 = randomIn(8, DISPLAY_WIDTH - 8), y0 = randomIn(8, DISPLAY_HEIGHT - 8);
+        int x1 = randomIn(8, DISPLAY_WIDTH - 8), y1 = randomIn(8, DISPLAY_HEIGHT - 8);
+        float length = sqrtf((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+        if (length < 32) continue;
+
+        beginLine();
+        AnimationUtils::drawLine(x0, y0, x1, y1, 0xFFFF, 255, 3);
+        AnimationUtils::resolveAccumulation();
+        float sum = 0;
+        for (int y = 0; y < DISPLAY_HEIGHT; y++) {
+            for (int x = 0; x < DISPLAY_WIDTH; x++) {
+                sum += accumulatedAt(x, y);
+            }
+        }
+        TEST_ASSERT_FLOAT_WITHIN(length * 3 * 0.01f, length * 3, sum);
+    }
+}
+
+// At width 1 a closed polyline blends every joint once, the closing one
+// included, so at half alpha the corners match the sides
+static void test_closed_polyline_blends_joints_once() {
+    const int16_t square[] = {10, 10, 40, 10, 40, 40, 10, 40};
+    AnimationUtils::drawPolyline(square, 4, 0xFFFF, 128, 1, true);
+
+    const uint16_t* frame = display.getRenderTarget();
+    uint16_t side = frame[10 * DISPLAY_WIDTH + 25];
+    TEST_ASSERT_TRUE(side != 0);
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_HEX16(side, frame[square[2 * i + 1] * DISPLAY_WIDTH + square[2 * i]]);
+    }
+}
+
+void setup() {
+    delay(2000); // Give the serial monitor time to attach
+    UNITY_BEGIN();
+    RUN_TEST(test_ellipse_spans_match_per_pixel_test);
+    RUN_TEST(test_fill_circle_edges_follow_the_distance);
+    RUN_TEST(test_circle_ring_follows_the_distance);
+    RUN_TEST(test_wu_line_columns_sum_to_one_pixel);
+    RUN_TEST(test_wide_line_covers_its_area);
+    RUN_TEST(test_closed_polyline_blends_joints_once);
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,205 @@
+// Sprites against what they replaced or stand for: span sprites against
+// the bitmaps they were generated from, alpha sprites against per-channel
+// alpha blending, clipped against unclipped and mirrored against plain,
+// and into an accumulation buffer against straight into RGB565. Runs on
+// the board:
+//
+//   pio test -e esp32doit-devkit-v1 -f test_sprites
+
+#include <Arduino.h>
+#include <unity.h>
+#include "animation_utils.h"
+#include "accumulation.h"
+#include "span_sprites.h"
+#include "alpha_sprites.h"
+#include "dvd_logo.h"
+
+static const int PIXELS = DISPLAY_WIDTH * DISPLAY_HEIGHT;
+
+static uint16_t expected[PIXELS];
+
+void setUp() {
+    display.clearData();
+}
+
+void tearDown() {}
+
+static void fillDisplay(uint16_t color) {
+    uint16_t* frame = display.getRenderTarget();
+    for (int i = 0; i < PIXELS; i++) {
+        frame[i] = color;
+    }
+}
+
+static int channelDiff(uint16_t a, uint16_t b) {
+    int dr = abs((a >> 11) - (b >> 11));
+    int dg = abs(((a >> 5) & 0x3F) - ((b >> 5) & 0x3F));
+    int db = abs((a & 0x1F) - (b & 0x1F));
+    return max(dr, max(dg, db));
+}
+
+// Every position that puts the logo on screen in steps of 3, clipped ones
+// included
+static void test_span_sprite_matches_bitmap() {
+    for (int y = -dvdLogoImageHeight + 1; y < DISPLAY_HEIGHT; y += 3) {
+        for (int x = -dvdLogoImageWidth + 1; x < DISPLAY_WIDTH; x += 3) {
+            display.clearData();
+            AnimationUtils::drawBitmapTransparent(x, y, dvd_logo_bitmap, dvdLogoImageWidth, dvdLogoImageHeight, 0x07FF);
+            memcpy(expected, display.getRenderTarget(), sizeof(expected));
+
+            display.clearData();
+            AnimationUtils::drawSprite(x, y, DVD_LOGO_SPRITE, 0x07FF);
+            TEST_ASSERT_EQUAL_MEMORY(expected, display.getRenderTarget(), sizeof(expected));
+        }
+    }
+}
+
+// A 16x16 sprite with every alpha, each pixel a different colour,
+// premultiplied the way scripts/png_sprites.py does it
+static const int SIDE = 16;
+static uint16_t straight[SIDE * SIDE];
+static uint16_t premultiplied[SIDE * SIDE];
+static uint8_t alphas[SIDE * SIDE];
+static const AlphaSprite ALPHAS = {SIDE, SIDE, premultiplied, alphas};
+
+static void makeSprite() {
+    for (int i = 0; i < SIDE * SIDE; i++) {
+        uint8_t r = i * 7, g = i * 13 + 50, b = 255 - i;
+        uint32_t weight = (i + 4) >> 3;
+        alphas[i] = i;
+        straight[i] = AnimationUtils::rgb888To565(r, g, b);
+        premultiplied[i] = ((((r >> 3) * weight) >> 5) << 11) | ((((g >> 2) * weight) >> 5) << 5) | (((b >> 3) * weight) >> 5);
+    }
+}
+
+static uint16_t blendReference(uint16_t dst, uint16_t src, float alpha) {
+    int r = lroundf((src >> 11) * alpha + (dst >> 11) * (1 - alpha));
+    int g = lroundf(((src >> 5) & 0x3F) * alpha + ((dst >> 5) & 0x3F) * (1 - alpha));
+    int b = lroundf((src & 0x1F) * alpha + (dst & 0x1F) * (1 - alpha));
+    return (r << 11) | (g << 5) | b;
+}
+
+// Within 2 steps of straight alpha blending, 4 when the sprite's alpha is
+// scaled too; over white nothing carries into the next channel
+static void test_alpha_sprite_blends_per_channel() {
+    makeSprite();
+    const uint16_t BACKGROUNDS[] = {0x0000, 0xFFFF, 0x8410, 0xF81F, 0x07E0};
+    const uint8_t SCALES[] = {255, 200, 128, 37};
+    for (uint16_t background : BACKGROUNDS) {
+        for (uint8_t scale : SCALES) {
+            fillDisplay(background);
+            AnimationUtils::drawSprite(8, 8, ALPHAS, scale);
+
+            const uint16_t* frame = display.getRenderTarget();
+            for (int j = 0; j < SIDE; j++) {
+                for (int i = 0; i < SIDE; i++) {
+                    float alpha = alphas[j * SIDE + i] / 255.0f * scale / 255.0f;
+                    uint16_t reference = blendReference(background, straight[j * SIDE + i], alpha);
+                    TEST_ASSERT_LESS_OR_EQUAL(scale == 255 ? 2 : 4, channelDiff(reference, frame[(8 + j) * DISPLAY_WIDTH + 8 + i]));
+                }
+            }
+        }
+    }
+}
+
+// Hanging off every edge and corner, each pixel on screen is what the same
+// sprite drew unclipped and everything else is left alone
+static void test_alpha_sprite_clips_without_wrapping() {
+    makeSprite();
+    fillDisplay(0x8410);
+    AnimationUtils::drawSprite(8, 8, ALPHAS);
+    uint16_t unclipped[SIDE * SIDE];
+    for (int j = 0; j < SIDE; j++) {
+        memcpy(&unclipped[j * SIDE], display.getRenderTarget() + (8 + j) * DISPLAY_WIDTH + 8, SIDE * sizeof(uint16_t));
+    }
+
+    const int XS[] = {-SIDE + 1, -5, 20, DISPLAY_WIDTH - 5, DISPLAY_WIDTH - 1};
+    const int YS[] = {-SIDE + 1, -5, 20, DISPLAY_HEIGHT - 5, DISPLAY_HEIGHT - 1};
+    for (int x : XS) {
+        for (int y : YS) {
+            fillDisplay(0x8410);
+            AnimationUtils::drawSprite(x, y, ALPHAS);
+
+            const uint16_t* frame = display.getRenderTarget();
+            for (int py = 0; py < DISPLAY_HEIGHT; py++) {
+                for (int px = 0; px < DISPLAY_WIDTH; px++) {
+                    int i = px - x, j = py - y;
+                    bool inside = i >= 0 && i < SIDE && j >= 0 && j < SIDE;
+                    TEST_ASSERT_EQUAL_HEX16(inside ? unclipped[j * SIDE + i] : 0x8410, frame[py * DISPLAY_WIDTH + px]);
+                }
+            }
+        }
+    }
+}
+
+static void test_alpha_sprite_flips() {
+    makeSprite();
+    fillDisplay(0x8410);
+    AnimationUtils::drawSprite(8, 8, ALPHAS, 180);
+    AnimationUtils::drawSprite(40, 8, ALPHAS, 180, SPRITE_FLIP_X);
+
+    const uint16_t* frame = display.getRenderTarget();
+    for (int j = 0; j < SIDE; j++) {
+        for (int i = 0; i < SIDE; i++) {
+            TEST_ASSERT_EQUAL_HEX16(frame[(8 + j) * DISPLAY_WIDTH + 8 + SIDE - 1 - i], frame[(8 + j) * DISPLAY_WIDTH + 40 + i]);
+        }
+    }
+}
+
+// Through an accumulation buffer the sprite lands within a step of where
+// it lands drawn straight into RGB565
+static void test_alpha_sprite_draws_into_accumulation() {
+    static uint32_t accumulation[PIXELS];
+    makeSprite();
+    for (int scale = 255; scale > 0; scale -= 100) {
+        fillDisplay(0x8410);
+        AnimationUtils::drawSprite(-3, 8, ALPHAS, scale, SPRITE_FLIP_X);
+        memcpy(expected, display.getRenderTarget(), sizeof(expected));
+
+        for (int i = 0; i < PIXELS; i++) {
+            accumulation[i] = Accumulation::from565(0x8410);
+        }
+        AnimationUtils::beginAccumulation(accumulation);
+        AnimationUtils::drawSprite(-3, 8, ALPHAS, scale, SPRITE_FLIP_X);
+        AnimationUtils::resolveAccumulation();
+
+        const uint16_t* frame = display.getRenderTarget();
+        for (int i = 0; i < PIXELS; i++) {
+            TEST_ASSERT_LESS_OR_EQUAL(1, channelDiff(expected[i], frame[i]));
+        }
+    }
+}
+
+// Beach's seabird as the eleven pixels it used to be plotted as
+static void test_seabird_matches_plotted_pixels() {
+    const int8_t BIRD[11][2] = {
+        {-3, 0}, {-2, 0}, {-2, -1}, {0, -1}, {0, 0}, {1, 0}, {2, -1}, {2, 0}, {3, 0}, {1, 1}, {2, 1}
+    };
+    for (int y = -2; y < DISPLAY_HEIGHT + 2; y += 5) {
+        for (int x = -4; x < DISPLAY_WIDTH + 4; x++) {
+            fillDisplay(0xFFFF);
+            for (int p = 0; p < 11; p++) {
+                display.drawPixel(x + BIRD[p][0], y + BIRD[p][1], 0);
+            }
+            memcpy(expected, display.getRenderTarget(), sizeof(expected));
+
+            fillDisplay(0xFFFF);
+            AnimationUtils::drawSprite(x - 3, y - 1, SEABIRD_SPRITE);
+            TEST_ASSERT_EQUAL_MEMORY(expected, display.getRenderTarget(), sizeof(expected));
+        }
+    }
+}
+
+void setup() {
+    delay(2000); // Give the serial monitor time to attach
+    UNITY_BEGIN();
+    RUN_TEST(test_span_sprite_matches_bitmap);
+    RUN_TEST(test_alpha_sprite_blends_per_channel);
+    RUN_TEST(test_alpha_sprite_clips_without_wrapping);
+    RUN_TEST(test_alpha_sprite_flips);
+    RUN_TEST(test_alpha_sprite_draws_into_accumulation);
+    RUN_TEST(test_seabird_matches_plotted_pixels);
+    UNITY_END();
+}
+
+void loop() {}
@@ -0,0 +1,75 @@
+// Transitions compose a frame from two animations' buffers without touching
+// either, so animations that build on their previous frame keep doing so
+// through a transition. Runs on the board:
+//
+//   pio test -e esp32doit-devkit-v1 -f test_transitions
+
+#include <Arduino.h>
+#include <unity.h>
+#include "transitions.h"
+#include "display_config.h"
+
+static const int PIXELS = DISPLAY_WIDTH * DISPLAY_HEIGHT;
+
+static uint16_t outgoing[PIXELS];
+static uint16_t incoming[PIXELS];
+static uint16_t out[PIXELS];
+static uint16_t first[PIXELS];
+
+void setUp() {
+    for (int i = 0; i < PIXELS; i++) {
+        outgoing[i] = (uint16_t)(i * 2654435761u >> 16);
+        incoming[i] = ~outgoing[i];
+    }
+}
+
+void tearDown() {}
+
+static bool sourcesUntouched() {
+    for (int i = 0; i < PIXELS; i++) {
+        if (outgoing[i] != (uint16_t)(i * 2654435761u >> 16) || incoming[i] != (uint16_t)~outgoing[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_sources_are_left_alone() {
+    for (int type = 0; type < TRANSITION_COUNT; type++) {
+        for (uint16_t progress = 0; progress <= Transitions::PROGRESS_MAX; progress += 32) {
+            Transitions::blend((TransitionType)type, out, outgoing, incoming, progress);
+            TEST_ASSERT_TRUE_MESSAGE(sourcesUntouched(), Transitions::getName((TransitionType)type));
+        }
+    }
+}
+
+static void test_ends_are_the_sources() {
+    for (int type = 0; type < TRANSITION_COUNT; type++) {
+        Transitions::blend((TransitionType)type, out, outgoing, incoming, 0);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(outgoing, out, PIXELS);
+        Transitions::blend((TransitionType)type, out, outgoing, incoming, Transitions::PROGRESS_MAX);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(incoming, out, PIXELS);
+    }
+}
+
+// The same inputs give the same frame however often they are blended, e.g.
+// a slide doesn't shift the outgoing pixels again on every frame
+static void test_blending_is_repeatable() {
+    for (int type = 0; type < TRANSITION_COUNT; type++) {
+        Transitions::blend((TransitionType)type, out, outgoing, incoming, 100);
+        memcpy(first, out, sizeof(first));
+        Transitions::blend((TransitionType)type, out, outgoing, incoming, 100);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(first, out, PIXELS);
+    }
+}
+
+void setup() {
+    delay(2000); // Give the serial monitor time to attach
+    UNITY_BEGIN();
+    RUN_TEST(test_sources_are_left_alone);
+    RUN_TEST(test_ends_are_the_sources);
+    RUN_TEST(test_blending_is_repeatable);
+    UNITY_END();
+}
+
+void loop() {}